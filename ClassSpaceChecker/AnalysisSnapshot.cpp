@@ -0,0 +1,322 @@
+#include "AnalysisSnapshot.h"
+
+#define SNAPSHOT_MAGIC		0x53435343		// "CSCS"
+#define SNAPSHOT_VERSION	5
+
+// The snapshot never leaves the machine that wrote it, values are kept in native byte order.
+class SnapshotWriter
+{
+public:
+	void writeInt(qint32 value) { data_.append((const char *)&value, sizeof(value)); }
+	void writeInt64(qint64 value) { data_.append((const char *)&value, sizeof(value)); }
+
+	void writeString(const QString &text)
+	{
+		QByteArray utf8 = text.toUtf8();
+		writeInt(utf8.size());
+		data_.append(utf8);
+	}
+
+	void writeBytes(const char *bytes, int length)
+	{
+		writeInt(length);
+		data_.append(bytes, length);
+	}
+
+	// index in the string table, the string is added the first time
+	void writeStringId(const QString &text)
+	{
+		QHash<QString, int>::iterator it = stringIds_.find(text);
+		if(it == stringIds_.end())
+		{
+			it = stringIds_.insert(text, strings_.size());
+			strings_.append(text);
+		}
+		writeInt(it.value());
+	}
+
+	const QByteArray &data() const { return data_; }
+	const QStringList &strings() const { return strings_; }
+
+private:
+	QByteArray data_;
+	QStringList strings_;
+	QHash<QString, int> stringIds_;
+};
+
+// Bounds checked reads over the mapped file. Once a read fails every next one fails too.
+class SnapshotReader
+{
+public:
+	SnapshotReader(const uchar *data, qint64 size) : pos_(data), end_(data + size), ok_(true)
+	{
+	}
+
+	bool ok() const { return ok_; }
+
+	qint32 readInt()
+	{
+		qint32 value = 0;
+		read(&value, sizeof(value));
+		return value;
+	}
+
+	qint64 readInt64()
+	{
+		qint64 value = 0;
+		read(&value, sizeof(value));
+		return value;
+	}
+
+	QString readString()
+	{
+		qint32 length = readInt();
+		if(!ok_ || length < 0 || length > end_ - pos_)
+		{
+			ok_ = false;
+			return QString();
+		}
+		QString text = QString::fromUtf8((const char *)pos_, length);
+		pos_ += length;
+		return text;
+	}
+
+	// the bytes stay in the mapped file
+	const char *readBytes(int *length)
+	{
+		*length = readInt();
+		if(!ok_ || *length < 0 || *length > end_ - pos_)
+		{
+			ok_ = false;
+			*length = 0;
+			return NULL;
+		}
+		const char *bytes = (const char *)pos_;
+		pos_ += *length;
+		return bytes;
+	}
+
+	const QString &readStringId(const QVector<QString> &strings)
+	{
+		static const QString empty;
+		qint32 id = readInt();
+		if(!ok_ || id < 0 || id >= strings.size())
+		{
+			ok_ = false;
+			return empty;
+		}
+		return strings.at(id);
+	}
+
+	int readSymbolId(const SymbolTable &symbols)
+	{
+		qint32 id = readInt();
+		if(!ok_ || id < 0 || id >= symbols.count())
+		{
+			ok_ = false;
+			return -1;
+		}
+		return id;
+	}
+
+private:
+	void read(void *value, int size)
+	{
+		if(!ok_ || size > end_ - pos_)
+		{
+			ok_ = false;
+			return;
+		}
+		memcpy(value, pos_, size);
+		pos_ += size;
+	}
+
+	const uchar *pos_;
+	const uchar *end_;
+	bool ok_;
+};
+
+static qint64 modifiedTime(const QFileInfo &info)
+{
+	return info.lastModified().toMSecsSinceEpoch();
+}
+
+bool AnalysisSnapshot::save(const QString &snapshotPath, const QString &jarPath, const QString &mapPath,
+	const QMap<QString, QString> &proguardMap, const ClassTable &classes,
+	const QStringList &containerPaths, const SymbolTable &symbols)
+{
+	QFileInfo jarInfo(jarPath);
+	if(!jarInfo.exists())
+		return false;
+
+	// rows first : the string table is only complete once every row has been written
+	SnapshotWriter rows;
+	rows.writeInt(proguardMap.size());
+	QMap<QString, QString>::const_iterator itMap = proguardMap.begin();
+	for(; itMap != proguardMap.end(); itMap++)
+	{
+		rows.writeStringId(itMap.key());
+		rows.writeStringId(itMap.value());
+	}
+
+	rows.writeInt(containerPaths.size());
+	for(int i = 0; i < containerPaths.size(); i++)
+		rows.writeStringId(containerPaths.at(i));
+
+	// the names are all in the symbol table, a row is its class id and numbers
+	rows.writeInt(classes.size());
+	for(int row = 0; row < classes.size(); row++)
+	{
+		rows.writeInt(classes.classId(row));
+		rows.writeInt(classes.containerIndex(row));
+		rows.writeInt(classes.zipIndex(row));
+		rows.writeInt(classes.crc(row));
+		rows.writeInt64(classes.fileSize(row));
+		rows.writeInt(classes.methodCount(row));
+		rows.writeInt(classes.referencedCount(row));
+		rows.writeInt(classes.javaFileFlag(row) ? 1 : 0);
+		rows.writeStringId(classes.parseError(row));
+
+		const QVector<int> &referencedList = classes.referencedList(row);
+		rows.writeInt(referencedList.size());
+		QVector<int>::const_iterator itRef = referencedList.begin();
+		for(; itRef != referencedList.end(); itRef++)
+			rows.writeInt(*itRef);
+	}
+
+	SnapshotWriter header;
+	header.writeInt(SNAPSHOT_MAGIC);
+	header.writeInt(SNAPSHOT_VERSION);
+	header.writeString(jarPath);
+	header.writeInt64(jarInfo.size());
+	header.writeInt64(modifiedTime(jarInfo));
+	header.writeString(mapPath);
+
+	const QStringList &strings = rows.strings();
+	header.writeInt(strings.size());
+	for(int i = 0; i < strings.size(); i++)
+		header.writeString(strings.at(i));
+
+	header.writeInt(symbols.count());
+	for(int i = 0; i < symbols.count(); i++)
+		header.writeBytes(symbols.name(i), symbols.length(i));
+
+	// written aside and renamed, a crash never leaves a half written snapshot behind
+	QString tempPath = snapshotPath + ".tmp";
+	QFile file(tempPath);
+	if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	bool ok = file.write(header.data()) == header.data().size()
+		&& file.write(rows.data()) == rows.data().size();
+	file.close();
+
+	QFile::remove(snapshotPath);
+	if(!ok || !QFile::rename(tempPath, snapshotPath))
+	{
+		QFile::remove(tempPath);
+		return false;
+	}
+	return true;
+}
+
+bool AnalysisSnapshot::load(const QString &snapshotPath, const QString &jarPath, const QString &mapPath,
+	QMap<QString, QString> &proguardMap, ClassTable &classes, QStringList &containerPaths,
+	SymbolTable &symbols)
+{
+	QFileInfo jarInfo(jarPath);
+	if(!jarInfo.exists())
+		return false;
+
+	QFile file(snapshotPath);
+	if(!file.open(QIODevice::ReadOnly))
+		return false;
+
+	qint64 size = file.size();
+	const uchar *data = file.map(0, size);
+	if(data == NULL)
+		return false;
+
+	SnapshotReader reader(data, size);
+	bool ok = reader.readInt() == SNAPSHOT_MAGIC
+		&& reader.readInt() == SNAPSHOT_VERSION
+		&& reader.readString() == jarPath
+		&& reader.readInt64() == jarInfo.size()
+		&& reader.readInt64() == modifiedTime(jarInfo)
+		&& reader.readString() == mapPath;
+
+	QVector<QString> strings;
+	if(ok)
+	{
+		int stringCount = reader.readInt();
+		for(int i = 0; i < stringCount && reader.ok(); i++)
+			strings.append(reader.readString());
+
+		// distinct names interned in order, they get their ids back
+		int symbolCount = reader.readInt();
+		for(int i = 0; i < symbolCount && ok && reader.ok(); i++)
+		{
+			int length;
+			const char *name = reader.readBytes(&length);
+			if(reader.ok() && symbols.intern(name, length) != i)
+				ok = false;
+		}
+	}
+
+	QMap<QString, QString> map;
+	QStringList paths;
+	ClassTable table;
+	if(ok && reader.ok())
+	{
+		int mapCount = reader.readInt();
+		for(int i = 0; i < mapCount && reader.ok(); i++)
+		{
+			const QString &key = reader.readStringId(strings);
+			map.insert(key, reader.readStringId(strings));
+		}
+
+		int containerCount = reader.readInt();
+		for(int i = 0; i < containerCount && reader.ok(); i++)
+			paths.append(reader.readStringId(strings));
+
+		int classCount = reader.readInt();
+		for(int i = 0; i < classCount && reader.ok(); i++)
+		{
+			int classId = reader.readSymbolId(symbols);
+			int containerIndex = reader.readInt();
+			int zipIndex = reader.readInt();
+			quint32 crc = reader.readInt();
+			long fileSize = (long)reader.readInt64();
+			int methodCount = reader.readInt();
+			int referencedCount = reader.readInt();
+			bool javaFileFlag = reader.readInt() != 0;
+			const QString &parseError = reader.readStringId(strings);
+			if(containerIndex < 0 || containerIndex >= paths.size())
+				break;
+
+			int row = table.append(classId, containerIndex, zipIndex, crc, fileSize, javaFileFlag);
+			table.setMethodCount(row, methodCount);
+			table.setReferencedCount(row, referencedCount);
+			table.setParseError(row, parseError);
+
+			int refCount = reader.readInt();
+			QVector<int> referencedList;
+			for(int j = 0; j < refCount && reader.ok(); j++)
+				referencedList.append(reader.readSymbolId(symbols));
+			table.setReferencedList(row, referencedList);
+		}
+		ok = ok && table.size() == classCount;
+	}
+	ok = ok && reader.ok();
+
+	file.unmap(const_cast<uchar *>(data));
+	file.close();
+
+	if(!ok)
+		return false;
+
+	proguardMap = map;
+	containerPaths = paths;
+	classes.append(table);
+	return true;
+}
@@ -0,0 +1,31 @@
+#ifndef ANALYSISSNAPSHOT_H
+#define ANALYSISSNAPSHOT_H
+
+#include <QtCore>
+#include "ClassTable.h"
+#include "SymbolTable.h"
+
+// Binary copy of an analyzed class table, so a jar that didn't change since its last
+// analysis can be shown again without reading it. The file starts with the jar path,
+// size and modification time it was made from, then a table of every distinct string
+// (names are stored once), the symbol table of the class names and the class table rows
+// pointing into both.
+// The entry bytes aren't saved, they are read from the jar when needed.
+class AnalysisSnapshot
+{
+public:
+	static bool save(const QString &snapshotPath, const QString &jarPath, const QString &mapPath,
+		const QMap<QString, QString> &proguardMap, const ClassTable &classes,
+		const QStringList &containerPaths, const SymbolTable &symbols);
+
+	// Fails if the snapshot was made from another jar or map path, or if the jar changed since.
+	// The file is mapped, decoded into rows appended to classes and unmapped.
+	// containerPaths are the paths of the rows' containers when the snapshot was saved, by
+	// containerIndex : the caller maps them to the jars it opens.
+	// The symbol ids of the rows are the ones of symbols, which must be empty.
+	static bool load(const QString &snapshotPath, const QString &jarPath, const QString &mapPath,
+		QMap<QString, QString> &proguardMap, ClassTable &classes, QStringList &containerPaths,
+		SymbolTable &symbols);
+};
+
+#endif // ANALYSISSNAPSHOT_H
@@ -0,0 +1,29 @@
+#ifndef CLASSFILECONTEXT_H
+#define CLASSFILECONTEXT_H
+
+#include <QtCore>
+
+class UniqueClassContext 
+{
+public:
+	int classCount;
+	int anonymousCount;
+	long fileSize;
+	QString uniqueClassName;
+};
+
+class PackageContext 
+{
+public:
+	int classCount;
+	int uniqueClassCount;
+	int anonymousClassCount;
+	long fileSize;
+	int unreachableClassCount;
+	long unreachableFileSize;
+	long retainedSize;
+	QSet<int> uniqueClassNameSet;	// SymbolTable ids
+	QString packageName;
+};
+
+#endif // CLASSFILECONTEXT_H
@@ -0,0 +1,124 @@
+#include "ClassTable.h"
+
+void ClassTable::clear()
+{
+	classIds_.clear();
+	originalIds_.clear();
+	containerIndexes_.clear();
+	zipIndexes_.clear();
+	crcs_.clear();
+	fileSizes_.clear();
+	methodCounts_.clear();
+	referencedCounts_.clear();
+	flags_.clear();
+	retainedSizes_.clear();
+	referencedLists_.clear();
+	parseErrors_.clear();
+}
+
+void ClassTable::reserve(int count)
+{
+	classIds_.reserve(count);
+	originalIds_.reserve(count);
+	containerIndexes_.reserve(count);
+	zipIndexes_.reserve(count);
+	crcs_.reserve(count);
+	fileSizes_.reserve(count);
+	methodCounts_.reserve(count);
+	referencedCounts_.reserve(count);
+	flags_.reserve(count);
+	retainedSizes_.reserve(count);
+	referencedLists_.reserve(count);
+}
+
+int ClassTable::append(int classId, int containerIndex, int zipIndex, quint32 crc, long fileSize, bool javaFileFlag)
+{
+	int row = classIds_.size();
+	classIds_.append(classId);
+	originalIds_.append(classId);
+	containerIndexes_.append(containerIndex);
+	zipIndexes_.append(zipIndex);
+	crcs_.append(crc);
+	fileSizes_.append(fileSize);
+	methodCounts_.append(-1);
+	referencedCounts_.append(-1);
+	flags_.append(javaFileFlag ? (JAVA_FILE | REACHABLE) : REACHABLE);
+	retainedSizes_.append(0);
+	referencedLists_.append(QVector<int>());
+	return row;
+}
+
+int ClassTable::append(const ClassTable &other, int row)
+{
+	int newRow = classIds_.size();
+	classIds_.append(other.classIds_.at(row));
+	originalIds_.append(other.originalIds_.at(row));
+	containerIndexes_.append(other.containerIndexes_.at(row));
+	zipIndexes_.append(other.zipIndexes_.at(row));
+	crcs_.append(other.crcs_.at(row));
+	fileSizes_.append(other.fileSizes_.at(row));
+	methodCounts_.append(other.methodCounts_.at(row));
+	referencedCounts_.append(other.referencedCounts_.at(row));
+	flags_.append(other.flags_.at(row));
+	retainedSizes_.append(other.retainedSizes_.at(row));
+	referencedLists_.append(other.referencedLists_.at(row));
+
+	QHash<int, QString>::const_iterator error = other.parseErrors_.find(row);
+	if(error != other.parseErrors_.end())
+		parseErrors_.insert(newRow, error.value());
+	return newRow;
+}
+
+void ClassTable::append(const ClassTable &other)
+{
+	int offset = classIds_.size();
+	classIds_ += other.classIds_;
+	originalIds_ += other.originalIds_;
+	containerIndexes_ += other.containerIndexes_;
+	zipIndexes_ += other.zipIndexes_;
+	crcs_ += other.crcs_;
+	fileSizes_ += other.fileSizes_;
+	methodCounts_ += other.methodCounts_;
+	referencedCounts_ += other.referencedCounts_;
+	flags_ += other.flags_;
+	retainedSizes_ += other.retainedSizes_;
+	referencedLists_ += other.referencedLists_;
+
+	QHash<int, QString>::const_iterator error = other.parseErrors_.begin();
+	for(; error != other.parseErrors_.end(); error++)
+		parseErrors_.insert(offset + error.key(), error.value());
+}
+
+void ClassTable::setEntry(int row, int containerIndex, int zipIndex)
+{
+	containerIndexes_[row] = containerIndex;
+	zipIndexes_[row] = zipIndex;
+}
+
+void ClassTable::setReachable(int row, bool reachable)
+{
+	if(reachable)
+		flags_[row] |= REACHABLE;
+	else
+		flags_[row] &= ~REACHABLE;
+}
+
+void ClassTable::setParseError(int row, const QString &error)
+{
+	if(error.isEmpty())
+		parseErrors_.remove(row);
+	else
+		parseErrors_.insert(row, error);
+}
+
+qint64 ClassTable::memoryUsage() const
+{
+	qint64 bytes = (qint64)classIds_.capacity() * sizeof(int) * 6
+		+ (qint64)crcs_.capacity() * sizeof(quint32)
+		+ (qint64)fileSizes_.capacity() * sizeof(long) * 2
+		+ (qint64)flags_.capacity() * sizeof(uchar)
+		+ (qint64)referencedLists_.capacity() * sizeof(QVector<int>);
+	for(int row = 0; row < referencedLists_.size(); row++)
+		bytes += (qint64)referencedLists_.at(row).capacity() * sizeof(int);
+	return bytes;
+}
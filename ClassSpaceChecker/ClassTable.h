@@ -0,0 +1,79 @@
+#ifndef CLASSTABLE_H
+#define CLASSTABLE_H
+
+#include <QtCore>
+
+// The .class and .java entries of the analyzed jar, one row each, stored by column : a scan or
+// an aggregate over a field walks one contiguous array instead of one heap item per class.
+// Names are SymbolTable ids, JarAnalyzer makes their QString forms when they are shown.
+// Rows are plain indexes, valid until the next load of the table.
+class ClassTable
+{
+public:
+	enum Flag
+	{
+		JAVA_FILE = 0x01,
+		REACHABLE = 0x02	// from the roots of the last collectData(), always set without roots
+	};
+
+	int size() const { return classIds_.size(); }
+	bool isEmpty() const { return classIds_.isEmpty(); }
+	void clear();
+	void reserve(int count);
+
+	// A row for an entry, its counts at -1 until the class is parsed.
+	// classId is the SymbolTable id of the entry name without its extension, "com/foo/Bar".
+	int append(int classId, int containerIndex, int zipIndex, quint32 crc, long fileSize, bool javaFileFlag);
+	// copies a row of another table
+	int append(const ClassTable &other, int row);
+	void append(const ClassTable &other);
+
+	int classId(int row) const { return classIds_.at(row); }
+	// SymbolTable id of the uncrypted name, the class id itself without a map
+	int originalId(int row) const { return originalIds_.at(row); }
+	// 0 for the analyzed jar, JarAnalyzer::container() otherwise
+	int containerIndex(int row) const { return containerIndexes_.at(row); }
+	int zipIndex(int row) const { return zipIndexes_.at(row); }
+	// of the jar entry, tells if a cached row is still up to date
+	quint32 crc(int row) const { return crcs_.at(row); }
+	long fileSize(int row) const { return fileSizes_.at(row); }
+	int methodCount(int row) const { return methodCounts_.at(row); }
+	int referencedCount(int row) const { return referencedCounts_.at(row); }
+	bool javaFileFlag(int row) const { return (flags_.at(row) & JAVA_FILE) != 0; }
+	bool isReachable(int row) const { return (flags_.at(row) & REACHABLE) != 0; }
+	// with the classes only reachable through this one, see JarAnalyzer::collectData()
+	long retainedSize(int row) const { return retainedSizes_.at(row); }
+	// SymbolTable ids of the referenced classes, sorted
+	const QVector<int> &referencedList(int row) const { return referencedLists_.at(row); }
+	// why the entry couldn't be read or parsed, empty if it was
+	QString parseError(int row) const { return parseErrors_.value(row); }
+
+	void setOriginalId(int row, int id) { originalIds_[row] = id; }
+	void setEntry(int row, int containerIndex, int zipIndex);
+	void setMethodCount(int row, int count) { methodCounts_[row] = count; }
+	void setReferencedCount(int row, int count) { referencedCounts_[row] = count; }
+	void addReferencedCount(int row, int delta) { referencedCounts_[row] += delta; }
+	void setReachable(int row, bool reachable);
+	void setRetainedSize(int row, long size) { retainedSizes_[row] = size; }
+	void setReferencedList(int row, const QVector<int> &ids) { referencedLists_[row] = ids; }
+	void setParseError(int row, const QString &error);
+
+	// bytes held by the columns, the reference lists included
+	qint64 memoryUsage() const;
+
+private:
+	QVector<int> classIds_;
+	QVector<int> originalIds_;
+	QVector<int> containerIndexes_;
+	QVector<int> zipIndexes_;
+	QVector<quint32> crcs_;
+	QVector<long> fileSizes_;
+	QVector<int> methodCounts_;
+	QVector<int> referencedCounts_;
+	QVector<uchar> flags_;
+	QVector<long> retainedSizes_;
+	QVector<QVector<int> > referencedLists_;
+	QHash<int, QString> parseErrors_;	// by row, only a few entries are broken
+};
+
+#endif // CLASSTABLE_H
@@ -0,0 +1,366 @@
+#include "DependencyGraph.h"
+
+DependencyGraph::DependencyGraph()
+{
+}
+
+void DependencyGraph::clear()
+{
+	rows_.clear();
+	nodeOfSymbol_.clear();
+	outOffsets_.clear();
+	targets_.clear();
+	inOffsets_.clear();
+	sources_.clear();
+	components_.clear();
+	componentSizes_.clear();
+}
+
+void DependencyGraph::build(const ClassTable &classes, int symbolCount)
+{
+	clear();
+
+	nodeOfSymbol_.fill(-1, symbolCount);
+	for(int row = 0; row < classes.size(); row++)
+	{
+		int classId = classes.classId(row);
+		if(classes.javaFileFlag(row) || classId < 0 || nodeOfSymbol_.at(classId) >= 0)
+			continue;
+		nodeOfSymbol_[classId] = rows_.size();
+		rows_.append(row);
+	}
+
+	// counted first, so each edge array is allocated once and filled in place
+	int count = rows_.size();
+	outOffsets_.fill(0, count + 1);
+	inOffsets_.fill(0, count + 1);
+	for(int node = 0; node < count; node++)
+	{
+		const QVector<int> &referencedList = classes.referencedList(rows_.at(node));
+		for(int i = 0; i < referencedList.size(); i++)
+		{
+			int target = nodeOfSymbol_.at(referencedList.at(i));
+			if(target < 0 || target == node)
+				continue;
+			outOffsets_[node + 1]++;
+			inOffsets_[target + 1]++;
+		}
+	}
+	for(int node = 0; node < count; node++)
+	{
+		outOffsets_[node + 1] += outOffsets_.at(node);
+		inOffsets_[node + 1] += inOffsets_.at(node);
+	}
+
+	targets_.resize(outOffsets_.at(count));
+	sources_.resize(inOffsets_.at(count));
+	QVector<int> inUsed = inOffsets_;
+	for(int node = 0; node < count; node++)
+	{
+		const QVector<int> &referencedList = classes.referencedList(rows_.at(node));
+		int used = outOffsets_.at(node);
+		for(int i = 0; i < referencedList.size(); i++)
+		{
+			int target = nodeOfSymbol_.at(referencedList.at(i));
+			if(target < 0 || target == node)
+				continue;
+			targets_[used++] = target;
+			sources_[inUsed[target]++] = node;
+		}
+	}
+
+	findComponents();
+}
+
+// Tarjan's algorithm with its recursion kept in two vectors : the call depth is the length
+// of the longest reference chain, far more than the thread stack holds on big jars.
+void DependencyGraph::findComponents()
+{
+	int count = nodeCount();
+	components_.fill(-1, count);
+	componentSizes_.clear();
+
+	QVector<int> index(count, -1);
+	QVector<int> low(count, 0);
+	QBitArray onStack(count);
+	QVector<int> stack;
+	QVector<int> callNodes;
+	QVector<int> callEdges;			// next edge of each called node
+	int nextIndex = 0;
+
+	for(int root = 0; root < count; root++)
+	{
+		if(index.at(root) >= 0)
+			continue;
+
+		index[root] = low[root] = nextIndex++;
+		stack.append(root);
+		onStack.setBit(root);
+		callNodes.append(root);
+		callEdges.append(outOffsets_.at(root));
+
+		while(!callNodes.isEmpty())
+		{
+			int top = callNodes.size() - 1;
+			int node = callNodes.at(top);
+			if(callEdges.at(top) < outOffsets_.at(node + 1))
+			{
+				int target = targets_.at(callEdges[top]++);
+				if(index.at(target) < 0)
+				{
+					index[target] = low[target] = nextIndex++;
+					stack.append(target);
+					onStack.setBit(target);
+					callNodes.append(target);
+					callEdges.append(outOffsets_.at(target));
+				}
+				else if(onStack.testBit(target))
+				{
+					low[node] = qMin(low.at(node), index.at(target));
+				}
+				continue;
+			}
+
+			// every edge of the node is done, back to its caller
+			callNodes.pop_back();
+			callEdges.pop_back();
+			if(!callNodes.isEmpty())
+			{
+				int caller = callNodes.last();
+				low[caller] = qMin(low.at(caller), low.at(node));
+			}
+
+			if(low.at(node) != index.at(node))
+				continue;
+
+			int component = componentSizes_.size();
+			int size = 0;
+			int member;
+			do
+			{
+				member = stack.last();
+				stack.pop_back();
+				onStack.clearBit(member);
+				components_[member] = component;
+				size++;
+			} while(member != node);
+			componentSizes_.append(size);
+		}
+	}
+}
+
+QList<QVector<int> > DependencyGraph::cycles() const
+{
+	QList<QVector<int> > result;
+	QVector<int> cycleOfComponent(componentCount(), -1);
+	for(int node = 0; node < nodeCount(); node++)
+	{
+		int component = components_.at(node);
+		if(componentSizes_.at(component) < 2)
+			continue;
+
+		if(cycleOfComponent.at(component) < 0)
+		{
+			cycleOfComponent[component] = result.size();
+			result.append(QVector<int>());
+		}
+		result[cycleOfComponent.at(component)].append(node);
+	}
+	return result;
+}
+
+QVector<int> DependencyGraph::dependencies(const QVector<int> &nodes) const
+{
+	return reachable(nodes, outOffsets_, targets_, -1);
+}
+
+QVector<int> DependencyGraph::dependents(const QVector<int> &nodes) const
+{
+	return reachable(nodes, inOffsets_, sources_, -1);
+}
+
+bool DependencyGraph::dependsOn(int from, int to) const
+{
+	// components are numbered in reverse topological order, nothing leads to a later one
+	if(components_.at(from) == components_.at(to))
+		return componentSizes_.at(components_.at(from)) > 1;
+	if(components_.at(to) > components_.at(from))
+		return false;
+
+	QVector<int> reached = reachable(QVector<int>(1, from), outOffsets_, targets_, to);
+	return !reached.isEmpty() && reached.last() == to;
+}
+
+QBitArray DependencyGraph::reachableFrom(const QVector<int> &roots) const
+{
+	QBitArray visited(nodeCount());
+	QVector<int> queue;
+	queue.reserve(nodeCount());
+	for(int i = 0; i < roots.size(); i++)
+	{
+		if(visited.testBit(roots.at(i)))
+			continue;
+		visited.setBit(roots.at(i));
+		queue.append(roots.at(i));
+	}
+
+	for(int i = 0; i < queue.size(); i++)
+	{
+		const int *edge = outEdges(queue.at(i));
+		const int *end = edge + outDegree(queue.at(i));
+		for(; edge != end; edge++)
+		{
+			if(visited.testBit(*edge))
+				continue;
+			visited.setBit(*edge);
+			queue.append(*edge);
+		}
+	}
+	return visited;
+}
+
+// Cooper, Harvey and Kennedy's iterative algorithm : the dominators of a node are intersected
+// over its predecessors, in reverse postorder, until nothing changes. A few passes are enough
+// on class graphs, Lengauer-Tarjan only pays off on much deeper loop nests.
+// The classes the roots reach are visited first and only their references from each other
+// are intersected, so an unreachable class referencing one of them never cuts its paths
+// from the roots.
+QVector<int> DependencyGraph::dominators(const QVector<int> &roots) const
+{
+	int count = nodeCount();
+	int virtualRoot = count;
+	QBitArray live = roots.isEmpty() ? QBitArray(count) : reachableFrom(roots);
+
+	QBitArray entry(count);
+	QVector<int> entries;
+	QBitArray rootComponent(componentCount());
+	for(int i = 0; i < roots.size(); i++)
+	{
+		rootComponent.setBit(components_.at(roots.at(i)));
+		if(entry.testBit(roots.at(i)))
+			continue;
+		entry.setBit(roots.at(i));
+		entries.append(roots.at(i));
+	}
+
+	QBitArray referenced(componentCount());
+	for(int node = 0; node < count; node++)
+	{
+		const int *edge = outEdges(node);
+		const int *end = edge + outDegree(node);
+		for(; edge != end; edge++)
+		{
+			if(components_.at(*edge) != components_.at(node))
+				referenced.setBit(components_.at(*edge));
+		}
+	}
+	for(int node = 0; node < count; node++)
+	{
+		int component = components_.at(node);
+		if(referenced.testBit(component) || rootComponent.testBit(component))
+			continue;
+		rootComponent.setBit(component);
+		entry.setBit(node);
+		entries.append(node);
+	}
+
+	// depth first postorder from the virtual root, same explicit stack as findComponents();
+	// the roots are the first entries, every live node is left before an unreachable one
+	QVector<int> postorder;
+	postorder.reserve(count + 1);
+	QVector<int> postIndex(count + 1, -1);
+	QBitArray visited(count + 1);
+	QVector<int> callNodes;
+	QVector<int> callEdges;
+	visited.setBit(virtualRoot);
+	callNodes.append(virtualRoot);
+	callEdges.append(0);
+	while(!callNodes.isEmpty())
+	{
+		int top = callNodes.size() - 1;
+		int node = callNodes.at(top);
+		const int *edges = (node == virtualRoot) ? entries.constData() : outEdges(node);
+		int degree = (node == virtualRoot) ? entries.size() : outDegree(node);
+		if(callEdges.at(top) < degree)
+		{
+			int target = edges[callEdges[top]++];
+			if(!visited.testBit(target))
+			{
+				visited.setBit(target);
+				callNodes.append(target);
+				callEdges.append(0);
+			}
+			continue;
+		}
+		callNodes.pop_back();
+		callEdges.pop_back();
+		postIndex[node] = postorder.size();
+		postorder.append(node);
+	}
+
+	QVector<int> idom(count + 1, -1);
+	idom[virtualRoot] = virtualRoot;
+	bool changed = true;
+	while(changed)
+	{
+		changed = false;
+		for(int i = postorder.size() - 2; i >= 0; i--)
+		{
+			int node = postorder.at(i);
+			int dominator = entry.testBit(node) ? virtualRoot : -1;
+			const int *source = inEdges(node);
+			const int *end = source + inDegree(node);
+			for(; source != end; source++)
+			{
+				int other = *source;
+				if(idom.at(other) < 0 || (live.testBit(node) && !live.testBit(other)))
+					continue;
+				if(dominator < 0)
+				{
+					dominator = other;
+					continue;
+				}
+				while(other != dominator)
+				{
+					while(postIndex.at(other) < postIndex.at(dominator))
+						other = idom.at(other);
+					while(postIndex.at(dominator) < postIndex.at(other))
+						dominator = idom.at(dominator);
+				}
+			}
+			if(idom.at(node) != dominator)
+			{
+				idom[node] = dominator;
+				changed = true;
+			}
+		}
+	}
+
+	idom.resize(count);
+	return idom;
+}
+
+// breadth first, stops as soon as stopNode is reached
+QVector<int> DependencyGraph::reachable(const QVector<int> &nodes, const QVector<int> &offsets, const QVector<int> &edges, int stopNode) const
+{
+	QVector<int> result;
+	QBitArray visited(nodeCount());
+	QVector<int> queue = nodes;
+	for(int i = 0; i < queue.size(); i++)
+	{
+		int node = queue.at(i);
+		for(int edge = offsets.at(node); edge < offsets.at(node + 1); edge++)
+		{
+			int target = edges.at(edge);
+			if(visited.testBit(target))
+				continue;
+
+			visited.setBit(target);
+			result.append(target);
+			if(target == stopNode)
+				return result;
+			queue.append(target);
+		}
+	}
+	return result;
+}
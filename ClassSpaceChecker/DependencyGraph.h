@@ -0,0 +1,67 @@
+#ifndef DEPENDENCYGRAPH_H
+#define DEPENDENCYGRAPH_H
+
+#include <QtCore>
+#include "ClassTable.h"
+
+// Class to class references of the analyzed jar, in compressed sparse rows : the edges of a
+// node are a slice of one int array, in both directions. A node is a class of the jar (the
+// first row of a name, .java entries left out), references to classes outside of the jar
+// and to the class itself are dropped.
+// The strongly connected components are found when the graph is built; a component of more
+// than one node is a reference cycle.
+class DependencyGraph
+{
+public:
+	DependencyGraph();
+
+	void build(const ClassTable &classes, int symbolCount);
+	void clear();
+
+	int nodeCount() const { return rows_.size(); }
+	int edgeCount() const { return targets_.size(); }
+	// -1 if the symbol isn't a class of the jar
+	int node(int symbolId) const { return (symbolId >= 0 && symbolId < nodeOfSymbol_.size()) ? nodeOfSymbol_.at(symbolId) : -1; }
+	// row of the node in the ClassTable it was built from
+	int rowAt(int node) const { return rows_.at(node); }
+
+	// referenced classes, then the classes referencing the node
+	int outDegree(int node) const { return outOffsets_.at(node + 1) - outOffsets_.at(node); }
+	const int *outEdges(int node) const { return targets_.constData() + outOffsets_.at(node); }
+	int inDegree(int node) const { return inOffsets_.at(node + 1) - inOffsets_.at(node); }
+	const int *inEdges(int node) const { return sources_.constData() + inOffsets_.at(node); }
+
+	int componentCount() const { return componentSizes_.size(); }
+	int component(int node) const { return components_.at(node); }
+	int componentSize(int component) const { return componentSizes_.at(component); }
+	// nodes of every component bigger than one node
+	QList<QVector<int> > cycles() const;
+
+	// every node reachable from the given ones, those not included unless a path leads back to them
+	QVector<int> dependencies(const QVector<int> &nodes) const;
+	// every node the given ones can be reached from
+	QVector<int> dependents(const QVector<int> &nodes) const;
+	bool dependsOn(int from, int to) const;
+	// the roots and every node reachable from them, one bit per node
+	QBitArray reachableFrom(const QVector<int> &roots) const;
+	// Immediate dominator of every node, nodeCount() for the ones only the virtual root above
+	// all entries dominates. The entries are the roots and a node of each component nothing
+	// references that holds no root, so every node gets one. The nodes the roots reach are
+	// dominated within the part of the graph they reach, the others within the rest.
+	QVector<int> dominators(const QVector<int> &roots) const;
+
+private:
+	void findComponents();
+	QVector<int> reachable(const QVector<int> &nodes, const QVector<int> &offsets, const QVector<int> &edges, int stopNode) const;
+
+	QVector<int> rows_;
+	QVector<int> nodeOfSymbol_;	// by SymbolTable id
+	QVector<int> outOffsets_;	// nodeCount() + 1 slice bounds into targets_
+	QVector<int> targets_;
+	QVector<int> inOffsets_;	// same for sources_
+	QVector<int> sources_;
+	QVector<int> components_;	// by node, numbered in reverse topological order
+	QVector<int> componentSizes_;
+};
+
+#endif // DEPENDENCYGRAPH_H
@@ -0,0 +1,778 @@
+#include "JarAnalyzer.h"
+#include "AnalysisSnapshot.h"
+#include "jclass/manifest.h"
+
+// "Outer$12" : what follows the first '$' is a positive number
+static bool isAnonymousName(const char *name, int length, int markPos)
+{
+	if(markPos + 1 >= length)
+		return false;
+
+	quint64 id = 0;
+	for(int i = markPos + 1; i < length; i++)
+	{
+		if(name[i] < '0' || name[i] > '9')
+			return false;
+		id = id * 10 + (name[i] - '0');
+		if(id > 0xffffffff)
+			return false;
+	}
+	return id > 0;
+}
+
+static bool packageLessThan(const PackageContext *a, const PackageContext *b)
+{
+	return a->packageName < b->packageName;
+}
+
+static bool uniqueClassLessThan(const UniqueClassContext *a, const UniqueClassContext *b)
+{
+	return a->uniqueClassName < b->uniqueClassName;
+}
+
+JarAnalyzer::JarAnalyzer() : collected_(false), reachabilityRootCount_(0), loadThreadCount_(0), loadedBytes_(0), reusedCount_(0)
+{
+	entryCache_.setMaxCost(DEFAULT_ENTRY_CACHE_SIZE);
+}
+
+JarAnalyzer::~JarAnalyzer()
+{
+	removeAll();
+}
+
+void JarAnalyzer::removeAll() 
+{
+	clearResults();
+	classes_.clear();
+	staleReferences_.clear();
+	addedRows_.clear();
+	collected_ = false;
+	reusedCount_ = 0;
+	symbols_.clear();
+
+	closeJars();
+}
+
+void JarAnalyzer::closeJars()
+{
+	entryCache_.clear();
+
+	// nested jars may be views into the mapping of the analyzed one
+	QList<JarReader*>::iterator it = nestedJars_.begin();
+	for(; it != nestedJars_.end(); it++)
+		delete *it;
+	nestedJars_.clear();
+
+	jarReader_.close();
+}
+
+bool JarAnalyzer::openJars(const QString & jarPath)
+{
+	closeJars();
+
+	if( !jarReader_.open(jarPath) ) 
+		return false;
+
+	JarLoader::openNestedJars(jarReader_, nestedJars_);
+	return true;
+}
+
+void JarAnalyzer::clearResults() 
+{
+	clearAggregates();
+
+	proguardMap_VK_.clear();
+	mapPath_.clear();
+	errorString_.clear();
+}
+
+void JarAnalyzer::clearAggregates() 
+{
+	qDeleteAll(packageMap_);
+	qDeleteAll(uniqueClassMap_);
+
+	uniqueClassMap_.clear();
+	packageMap_.clear();
+	graph_.clear();
+	reachabilityRootCount_ = 0;
+}
+
+bool JarAnalyzer::loadMapFile(const QString & mapPath) 
+{
+	QFile file(mapPath);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		errorString_ = "Proguard Map file not found.";
+		return false;
+	}
+
+	mapPath_ = mapPath;
+
+	while (!file.atEnd()) 
+	{
+		QByteArray line = file.readLine();
+		QString lineStr(line);
+		lineStr = lineStr.trimmed();
+
+		if(lineStr.lastIndexOf(':') != lineStr.length() - 1) 
+			continue;
+
+		int pos = lineStr.indexOf("->");
+		if(pos < 0)
+			continue;
+
+		QString key;
+		QString value;
+
+		key = lineStr.left(pos).trimmed();
+		value = lineStr.mid(pos + 2).trimmed().remove(":");
+
+		proguardMap_VK_.insert(value, key);
+	}
+
+	return true;
+}
+
+bool JarAnalyzer::loadKeepFile(const QString & keepPath) 
+{
+	QFile file(keepPath);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		errorString_ = "Keep class file not found.";
+		return false;
+	}
+
+	while (!file.atEnd()) 
+	{
+		QByteArray line = file.readLine();
+		QString lineStr = QString::fromUtf8(line.constData(), line.size()).trimmed();
+		if(lineStr.isEmpty() || lineStr.startsWith('#'))
+			continue;
+		roots_.keepClasses.append(lineStr);
+	}
+
+	return true;
+}
+
+bool JarAnalyzer::loadJarFile(const QString & jarPath, ProgressListener *listener)
+{
+	// rows of the last analysis are reused for the entries that didn't change,
+	// as long as their reference counts are complete
+	ClassTable cachedClasses;
+	QHash<QString, int> cache;
+	// the graph points to rows replaced below
+	graph_.clear();
+	if(collected_)
+	{
+		cachedClasses = classes_;
+		for(int row = 0; row < cachedClasses.size(); row++)
+		{
+			QString key = JarLoader::cacheKey(containerPath(row), filePath(row));
+			if(cache.contains(key))
+			{
+				staleReferences_.append(cachedClasses.referencedList(row));
+				continue;
+			}
+			cache.insert(key, row);
+		}
+	}
+	else
+	{
+		staleReferences_.clear();
+	}
+	classes_.clear();
+	addedRows_.clear();
+	collected_ = false;
+
+	// kept open until the next load, entry bytes can be read again by index
+	if( !openJars(jarPath) ) 
+	{
+		removeAll();
+		errorString_ = "Jar file not found.";
+		return false;
+	}
+
+	JarLoader loader(jarReader_, symbols_, nestedJars_);
+	loader.load(classes_, listener, &cachedClasses, &cache);
+
+	loadThreadCount_ = loader.threadCount();
+	loadedBytes_ = loader.totalBytes();
+	reusedCount_ = loader.reusedCount();
+
+	if(loader.canceled())
+		return cancel();
+
+	// what is left in the cache changed or is gone from the jar
+	QHash<QString, int>::const_iterator it = cache.begin();
+	for(; it != cache.end(); it++)
+		staleReferences_.append(cachedClasses.referencedList(it.value()));
+
+	addedRows_ = loader.loadedRows();
+	return true;
+}
+
+bool JarAnalyzer::collectData(ProgressListener *listener)
+{
+	clearAggregates();
+
+	// with only a few changed entries, adjusting the kept counts is much cheaper than counting again
+	bool incremental = (collected_ || reusedCount_ > 0);
+	if(incremental && (!addedRows_.isEmpty() || !staleReferences_.isEmpty()))
+		updateReferencedCount();
+
+	QVector<int> referencedCounts;
+	if(!incremental)
+		referencedCounts = countReferences();
+
+	// the map by symbol, a row is looked up by its class id instead of by its name
+	QHash<int, int> originalIds;
+	QMap<QString, QString>::const_iterator itMap = proguardMap_VK_.begin();
+	for(; itMap != proguardMap_VK_.end(); itMap++)
+	{
+		QByteArray key = itMap.key().toUtf8();
+		key.replace('.', '/');
+		int classId = symbols_.find(key.constData(), key.size());
+		if(classId < 0)
+			continue;
+		QByteArray name = itMap.value().toUtf8();
+		name.replace('.', '/');
+		originalIds.insert(classId, symbols_.intern(name));
+	}
+
+	QVector<PackageContext*> packageOfClass(classes_.size());
+
+	for(int i = 0; i < classes_.size(); i++)
+	{
+		// the counts are only partly done, nothing can be kept
+		if(listener != NULL && listener->isCanceled())
+			return cancel();
+		
+		// a reused row may still have the name of the previous map.
+		// The aggregates are keyed by symbol, the names are only split on their bytes.
+		int originalId = originalIds.value(classes_.classId(i), classes_.classId(i));
+		classes_.setOriginalId(i, originalId);
+
+		if(!incremental)
+			classes_.addReferencedCount(i, referencedCounts.at(classes_.classId(i)));
+
+		const char *name = symbols_.name(originalId);
+		int length = symbols_.length(originalId);
+		int pos = length - 1;
+		while(pos >= 0 && name[pos] != '/')
+			pos--;
+		int packageId = (pos >= 0) ? symbols_.intern(name, pos) : originalId;
+
+		// interning can add names, the maps follow the table
+		if(packageMap_.size() < symbols_.count())
+		{
+			packageMap_.resize(symbols_.count());
+			uniqueClassMap_.resize(symbols_.count());
+		}
+
+		PackageContext* ctxPackage = packageMap_.at(packageId);
+		if(ctxPackage == NULL)
+		{
+			ctxPackage = new PackageContext();
+			ctxPackage->classCount = 0;
+			ctxPackage->anonymousClassCount = 0;
+			ctxPackage->fileSize = 0;
+			ctxPackage->unreachableClassCount = 0;
+			ctxPackage->unreachableFileSize = 0;
+			ctxPackage->retainedSize = 0;
+			ctxPackage->packageName = symbols_.text(packageId);
+			packageMap_[packageId] = ctxPackage;
+		}
+
+		bool anonymousClassFlag = false;
+		int uniqueClassId = originalId;
+		{
+			int pos = 0;
+			while(pos < length && name[pos] != '$')
+				pos++;
+			if(pos < length) {
+				uniqueClassId = symbols_.intern(name, pos);
+				if(isAnonymousName(name, length, pos)) 
+				{
+					ctxPackage->anonymousClassCount++;
+					anonymousClassFlag = true;
+				}
+			}
+		}
+
+		if(uniqueClassMap_.size() < symbols_.count())
+		{
+			packageMap_.resize(symbols_.count());
+			uniqueClassMap_.resize(symbols_.count());
+		}
+
+		packageOfClass[i] = ctxPackage;
+		ctxPackage->fileSize += classes_.fileSize(i);
+		ctxPackage->classCount++;
+		ctxPackage->uniqueClassNameSet.insert(uniqueClassId);
+		
+		UniqueClassContext* ctxUniqueClass = uniqueClassMap_.at(uniqueClassId);
+		if(ctxUniqueClass == NULL)
+		{
+			ctxUniqueClass = new UniqueClassContext();
+			ctxUniqueClass->classCount = 0;
+			ctxUniqueClass->anonymousCount = 0;
+			ctxUniqueClass->fileSize = 0;
+			ctxUniqueClass->uniqueClassName = symbols_.text(uniqueClassId);
+			uniqueClassMap_[uniqueClassId] = ctxUniqueClass;
+		}
+
+		ctxUniqueClass->fileSize += classes_.fileSize(i);
+		ctxUniqueClass->classCount++;
+		if(anonymousClassFlag)
+			ctxUniqueClass->anonymousCount++;
+
+		if(listener != NULL && ((i + 1) % 256 == 0 || i + 1 == classes_.size()))
+			listener->onProgress(i + 1, classes_.size());
+	}
+
+	graph_.build(classes_, symbols_.count());
+	QVector<int> roots = reachabilityRootNodes();
+	markReachableClasses(roots, packageOfClass);
+	computeRetainedSizes(roots, packageOfClass);
+
+	staleReferences_.clear();
+	addedRows_.clear();
+	collected_ = true;
+	return true;
+}
+
+bool JarAnalyzer::cancel()
+{
+	removeAll();
+	errorString_ = "Canceled";
+	return false;
+}
+
+// Applies the changes of the last load to the referenced counts of the previous analysis :
+// the classes referenced by a stale row lose one, the ones referenced by a new row gain one
+// and only the new rows are counted against the whole table.
+void JarAnalyzer::updateReferencedCount()
+{
+	QHash<int, QVector<int> > rowsById;
+	for(int row = 0; row < classes_.size(); row++)
+		rowsById[classes_.classId(row)].append(row);
+
+	QBitArray addedRows(classes_.size());
+	for(int i = 0; i < addedRows_.size(); i++)
+		addedRows.setBit(addedRows_.at(i));
+
+	for(int i = 0; i < staleReferences_.size(); i++)
+		addReferencedCount(rowsById, addedRows, staleReferences_.at(i), -1);
+
+	QVector<int> referencedCounts = countReferences();
+	for(int i = 0; i < addedRows_.size(); i++)
+	{
+		int row = addedRows_.at(i);
+		addReferencedCount(rowsById, addedRows, classes_.referencedList(row), 1);
+		classes_.addReferencedCount(row, referencedCounts.at(classes_.classId(row)));
+	}
+}
+
+// Number of classes referencing each symbol, by symbol id : one pass over all the reference
+// lists instead of looking every class up in every list. A list holds an id at most once.
+QVector<int> JarAnalyzer::countReferences() const
+{
+	QVector<int> referencedCounts(symbols_.count(), 0);
+	int *counts = referencedCounts.data();
+
+	for(int row = 0; row < classes_.size(); row++)
+	{
+		const QVector<int> &referencedList = classes_.referencedList(row);
+		const int *id = referencedList.constData();
+		const int *end = id + referencedList.size();
+		for(; id != end; id++)
+			counts[*id]++;
+	}
+	return referencedCounts;
+}
+
+// Main-Class of the manifest, then the classes matching a keep name or pattern
+QVector<int> JarAnalyzer::reachabilityRootNodes() const
+{
+	QVector<int> nodes;
+
+	int manifestIndex = jarReader_.find("META-INF/MANIFEST.MF");
+	if(roots_.useMainClass && manifestIndex >= 0)
+	{
+		// a line longer than 72 bytes goes on in the next one, after a space
+		QByteArray bytes = jarReader_.read(manifestIndex);
+		bytes.replace("\r\n ", "");
+		bytes.replace("\n ", "");
+
+		Manifest *manifest = jclass_manifest_new_from_buffer(bytes.constData(), bytes.size());
+		const char *mainClass = jclass_manifest_get_entry(manifest, NULL, "Main-Class");
+		if(mainClass != NULL)
+		{
+			QByteArray name = QByteArray(mainClass).trimmed();
+			name.replace('.', '/');
+			int node = graph_.node(symbols_.find(name.constData(), name.size()));
+			if(node >= 0)
+				nodes.append(node);
+		}
+		jclass_manifest_free(manifest);
+	}
+
+	if(roots_.keepClasses.isEmpty() && roots_.namePatterns.isEmpty())
+		return nodes;
+
+	QSet<QString> keepSet = roots_.keepClasses.toSet();
+	QList<QRegExp> patterns;
+	for(int i = 0; i < roots_.namePatterns.size(); i++)
+		patterns.append(QRegExp(roots_.namePatterns.at(i)));
+
+	for(int node = 0; node < graph_.nodeCount(); node++)
+	{
+		QString className = this->className(graph_.rowAt(node));
+		QString originalName = this->originalName(graph_.rowAt(node));
+		bool root = keepSet.contains(className) || keepSet.contains(originalName);
+		for(int i = 0; !root && i < patterns.size(); i++)
+			root = patterns[i].exactMatch(className) || patterns[i].exactMatch(originalName);
+		if(root)
+			nodes.append(node);
+	}
+	return nodes;
+}
+
+// A class no root leads to is unreachable, even when other unreachable classes reference it.
+// The rows of a class share its node, .java entries are never unreachable.
+void JarAnalyzer::markReachableClasses(const QVector<int> &roots, const QVector<PackageContext*> &packageOfClass)
+{
+	reachabilityRootCount_ = roots.size();
+	QBitArray reached = graph_.reachableFrom(roots);
+
+	for(int i = 0; i < classes_.size(); i++)
+	{
+		int node = graph_.node(classes_.classId(i));
+		bool reachable = (roots.isEmpty() || classes_.javaFileFlag(i) || node < 0 || reached.testBit(node));
+		classes_.setReachable(i, reachable);
+		if(reachable)
+			continue;
+
+		packageOfClass.at(i)->unreachableClassCount++;
+		packageOfClass.at(i)->unreachableFileSize += classes_.fileSize(i);
+	}
+}
+
+// The retained size of a class is the size of its subtree in the dominator tree : the class and
+// every class all paths from the roots to go through it. A package retains the subtrees of its
+// classes no other class of the package dominates, a lower bound when only the package as a
+// whole cuts a path. Rows outside of the graph retain their own size.
+void JarAnalyzer::computeRetainedSizes(const QVector<int> &roots, const QVector<PackageContext*> &packageOfClass)
+{
+	int count = graph_.nodeCount();
+	QVector<int> idom = graph_.dominators(roots);
+
+	QVector<long> retained(count + 1, 0);
+	QVector<int> packageOfNode(count, 0);
+	QVector<PackageContext*> packages;
+	QHash<PackageContext*, int> packageIndex;
+	for(int i = 0; i < classes_.size(); i++)
+	{
+		PackageContext* ctxPackage = packageOfClass.at(i);
+		int node = graph_.node(classes_.classId(i));
+		if(node < 0 || graph_.rowAt(node) != i)
+		{
+			ctxPackage->retainedSize += classes_.fileSize(i);
+			continue;
+		}
+
+		QHash<PackageContext*, int>::const_iterator found = packageIndex.find(ctxPackage);
+		if(found == packageIndex.end())
+		{
+			found = packageIndex.insert(ctxPackage, packages.size());
+			packages.append(ctxPackage);
+		}
+		packageOfNode[node] = found.value();
+		retained[node] = classes_.fileSize(i);
+	}
+
+	// children of each node in the dominator tree, the virtual root last
+	QVector<int> childOffsets(count + 2, 0);
+	for(int node = 0; node < count; node++)
+		childOffsets[idom.at(node) + 1]++;
+	for(int node = 0; node <= count; node++)
+		childOffsets[node + 1] += childOffsets.at(node);
+	QVector<int> children(count);
+	QVector<int> childUsed = childOffsets;
+	for(int node = 0; node < count; node++)
+		children[childUsed[idom.at(node)]++] = node;
+
+	// depth first, a subtree is summed when it is left; a node is the topmost of its package
+	// when no node of the package is open above it
+	QVector<int> openCount(packages.size(), 0);
+	QBitArray topmost(count);
+	QVector<int> callNodes(1, count);
+	QVector<int> callChildren(1, childOffsets.at(count));
+	while(!callNodes.isEmpty())
+	{
+		int top = callNodes.size() - 1;
+		int node = callNodes.at(top);
+		if(callChildren.at(top) < childOffsets.at(node + 1))
+		{
+			int child = children.at(callChildren[top]++);
+			if(openCount[packageOfNode.at(child)]++ == 0)
+				topmost.setBit(child);
+			callNodes.append(child);
+			callChildren.append(childOffsets.at(child));
+			continue;
+		}
+
+		callNodes.pop_back();
+		callChildren.pop_back();
+		if(node == count)
+			break;
+		retained[idom.at(node)] += retained.at(node);
+		openCount[packageOfNode.at(node)]--;
+		if(topmost.testBit(node))
+			packages.at(packageOfNode.at(node))->retainedSize += retained.at(node);
+	}
+
+	for(int i = 0; i < classes_.size(); i++)
+	{
+		int node = graph_.node(classes_.classId(i));
+		classes_.setRetainedSize(i, (node >= 0 && graph_.rowAt(node) == i) ? retained.at(node) : classes_.fileSize(i));
+	}
+}
+
+void JarAnalyzer::addReferencedCount(const QHash<int, QVector<int> > &rowsById, const QBitArray &addedRows,
+	const QVector<int> &referencedList, int delta)
+{
+	QVector<int>::const_iterator it = referencedList.begin();
+	for(; it != referencedList.end(); it++)
+	{
+		QHash<int, QVector<int> >::const_iterator found = rowsById.find(*it);
+		if(found == rowsById.end())
+			continue;
+
+		// new rows are counted from scratch
+		const QVector<int> &rows = found.value();
+		for(int i = 0; i < rows.size(); i++)
+		{
+			if(!addedRows.testBit(rows.at(i)))
+				classes_.addReferencedCount(rows.at(i), delta);
+		}
+	}
+}
+
+
+bool JarAnalyzer::saveSnapshot(const QString & snapshotPath) const
+{
+	if(!collected_)
+		return false;
+
+	QStringList containerPaths;
+	containerPaths.append(QString());
+	for(int i = 0; i < nestedJars_.size(); i++)
+		containerPaths.append(nestedJars_.at(i)->path());
+
+	return AnalysisSnapshot::save(snapshotPath, jarReader_.path(), mapPath_, proguardMap_VK_, classes_, containerPaths, symbols_);
+}
+
+bool JarAnalyzer::loadSnapshot(const QString & snapshotPath, const QString & jarPath, const QString & mapPath)
+{
+	// the current analysis stays as it is if there's no usable snapshot
+	QMap<QString, QString> proguardMap;
+	ClassTable classes;
+	QStringList containerPaths;
+	SymbolTable symbols;
+	if(!AnalysisSnapshot::load(snapshotPath, jarPath, mapPath, proguardMap, classes, containerPaths, symbols))
+		return false;
+
+	removeAll();
+	proguardMap_VK_ = proguardMap;
+	classes_ = classes;
+	// the ids of the rows are the ones of the snapshot names, interned in the same order
+	for(int i = 0; i < symbols.count(); i++)
+		symbols_.intern(symbols.name(i), symbols.length(i));
+
+	// same jar as the snapshot, the entry bytes are read from it when needed
+	if(!openJars(jarPath))
+	{
+		removeAll();
+		return false;
+	}
+
+	// the nested jars are opened again, in an order of their own
+	QHash<QString, int> containerIndex;
+	containerIndex.insert(QString(), 0);
+	for(int i = 0; i < nestedJars_.size(); i++)
+		containerIndex.insert(nestedJars_.at(i)->path(), i + 1);
+
+	QVector<int> indexOfSaved(containerPaths.size());
+	for(int i = 0; i < containerPaths.size(); i++)
+	{
+		QHash<QString, int>::iterator found = containerIndex.find(containerPaths.at(i));
+		if(found == containerIndex.end())
+		{
+			removeAll();
+			return false;
+		}
+		indexOfSaved[i] = found.value();
+	}
+
+	for(int row = 0; row < classes_.size(); row++)
+		classes_.setEntry(row, indexOfSaved.at(classes_.containerIndex(row)), classes_.zipIndex(row));
+
+	mapPath_ = mapPath;
+	collected_ = true;
+	return true;
+}
+
+void JarAnalyzer::setEntryCacheSize(int bytes)
+{
+	entryCache_.setMaxCost(bytes);
+}
+
+const JarReader *JarAnalyzer::container(int index) const
+{
+	if(index == 0)
+		return &jarReader_;
+	return nestedJars_.value(index - 1, NULL);
+}
+
+QString JarAnalyzer::filePath(int row) const
+{
+	const JarReader *reader = container(classes_.containerIndex(row));
+	int zipIndex = classes_.zipIndex(row);
+	if(reader != NULL && zipIndex >= 0 && zipIndex < reader->count())
+		return reader->entry(zipIndex).name;
+
+	// the jar is closed, the name is made again from the class name
+	return QString::fromUtf8(symbols_.name(classes_.classId(row)), symbols_.length(classes_.classId(row)))
+		+ (classes_.javaFileFlag(row) ? ".java" : ".class");
+}
+
+QString JarAnalyzer::fullClassNameForKey(int row) const
+{
+	QByteArray name = symbols_.bytes(classes_.classId(row));
+	name.replace('/', '_');
+	return QString::fromUtf8(name.constData(), name.size());
+}
+
+QString JarAnalyzer::containerPath(int row) const
+{
+	const JarReader *reader = container(classes_.containerIndex(row));
+	if(classes_.containerIndex(row) == 0 || reader == NULL)
+		return QString();
+	return reader->path();
+}
+
+QByteArray JarAnalyzer::entryBytes(int row) const
+{
+	int containerIndex = classes_.containerIndex(row);
+	int zipIndex = classes_.zipIndex(row);
+	const JarReader *reader = container(containerIndex);
+	if(zipIndex < 0 || reader == NULL || !reader->isOpen())
+		return QByteArray();
+
+	qint64 key = ((qint64)containerIndex << 32) | zipIndex;
+	QByteArray *cached = entryCache_.object(key);
+	if(cached != NULL)
+		return *cached;
+
+	// an entry bigger than the whole budget is read every time
+	QByteArray bytes = reader->read(zipIndex);
+	entryCache_.insert(key, new QByteArray(bytes), bytes.size());
+	return bytes;
+}
+
+// The inner and anonymous class filters only look at the name bytes in the symbol table,
+// a name is decoded for the filters that match text.
+QVector<int> JarAnalyzer::search(const SearchFilter &filter) const
+{
+	QVector<int> result;
+
+	QRegExp searchName(filter.searchName, Qt::CaseInsensitive);
+	QRegExp searchText(filter.searchText, Qt::CaseSensitive);
+	QByteArray searchBytes = filter.searchText.toStdString().c_str();
+
+	for(int row = 0; row < classes_.size(); row++)
+	{
+		int originalId = classes_.originalId(row);
+		const char *name = symbols_.name(originalId);
+		int length = symbols_.length(originalId);
+		const char *mark = (const char *)memchr(name, '$', length);
+		int markPos = (mark != NULL) ? (int)(mark - name) : -1;
+		if(filter.ignoreInnerClass && markPos > 0)
+			continue;
+
+		if(filter.onlyAnonymousClass && !isAnonymousName(name, length, markPos))
+			continue;
+
+		if(filter.useAsPackageName)
+		{
+			QString originalName = symbols_.text(originalId);
+			int posTemp = originalName.indexOf(filter.searchName);
+			if(posTemp < 0)
+				continue;
+			posTemp = originalName.indexOf(".", posTemp + filter.searchName.length() + 1);
+			if(posTemp > 0)
+				continue;
+		}
+		else 
+		{
+			if(filter.searchName.isEmpty() == false)
+			{
+				int id = filter.useUncryptName ? originalId : classes_.classId(row);
+				if(symbols_.text(id).contains(searchName) == false)
+					continue;
+			}
+		}
+
+		if(filter.searchText.isEmpty() == false)
+		{
+			// read again from the jar unless still in the entry cache
+			QByteArray decompiledBuffer = entryBytes(row);
+			if(classes_.javaFileFlag(row)) 
+			{
+				QString decompiledBufferStr = decompiledBuffer;
+				if(decompiledBufferStr.contains(searchText) == false)
+					continue;
+			}
+			else
+			{
+				if(decompiledBuffer.contains(searchBytes.constData()) == false)
+					continue;
+			}
+		}
+
+		result.append(row);
+	}
+	return result;
+}
+
+QList<const UniqueClassContext*> JarAnalyzer::innerClassReport() const
+{
+	QList<const UniqueClassContext*> result;
+
+	QVector<UniqueClassContext*>::const_iterator it = uniqueClassMap_.begin();
+	for(; it != uniqueClassMap_.end(); it++)
+	{
+		const UniqueClassContext* ctx = *it;
+		// only the classes that have inner classes
+		if(ctx == NULL || ctx->classCount < 2)
+			continue;
+		result.append(ctx);
+	}
+	qSort(result.begin(), result.end(), uniqueClassLessThan);
+	return result;
+}
+
+QList<const PackageContext*> JarAnalyzer::packageReport() const
+{
+	QList<const PackageContext*> result;
+
+	QVector<PackageContext*>::const_iterator it = packageMap_.begin();
+	for(; it != packageMap_.end(); it++)
+	{
+		if(*it != NULL)
+			result.append(*it);
+	}
+	qSort(result.begin(), result.end(), packageLessThan);
+	return result;
+}
@@ -0,0 +1,151 @@
+#ifndef JARANALYZER_H
+#define JARANALYZER_H
+
+#include <QtCore>
+#include "XZip/JarReader.h"
+#include "ClassFileContext.h"
+#include "ClassTable.h"
+#include "JarLoader.h"
+#include "SymbolTable.h"
+#include "DependencyGraph.h"
+
+// Options of a class search, the check boxes of the main window
+class SearchFilter
+{
+public:
+	SearchFilter() : useUncryptName(false), ignoreInnerClass(false), onlyAnonymousClass(false), useAsPackageName(false)
+	{
+	}
+
+	QString searchName;
+	QString searchText;
+	bool useUncryptName;
+	bool ignoreInnerClass;
+	bool onlyAnonymousClass;
+	bool useAsPackageName;
+};
+
+// Entry points of the reachability analysis. Names are matched as the reports show them,
+// "com.foo.Bar", against the class name and its uncrypted name.
+class ReachabilityRoots
+{
+public:
+	ReachabilityRoots() : useMainClass(true)
+	{
+	}
+
+	bool useMainClass;			// Main-Class of the jar manifest
+	QStringList namePatterns;	// regular expressions matching the whole name
+	QStringList keepClasses;
+};
+
+// Everything the analysis does without any widget : jar and proguard map loading,
+// the package and inner class aggregates and the rows of the three reports.
+// Shared by the main window and the command line analyzer.
+class JarAnalyzer
+{
+public:
+	enum { DEFAULT_ENTRY_CACHE_SIZE = 32 * 1024 * 1024 };
+
+	JarAnalyzer();
+	~JarAnalyzer();
+
+	void removeAll();
+	// Drops the map and the reports but keeps the loaded classes : the next loadJarFile()
+	// only reads the entries whose crc or size changed and collectData() updates the counts.
+	void clearResults();
+	bool loadMapFile(const QString & mapPath);
+	// Used by the next collectData(). Without any root found in the jar every class is
+	// left reachable.
+	void setReachabilityRoots(const ReachabilityRoots &roots) { roots_ = roots; }
+	const ReachabilityRoots &reachabilityRoots() const { return roots_; }
+	// one class name per line added to the keep classes, '#' starts a comment
+	bool loadKeepFile(const QString & keepPath);
+	// Both fail when the listener cancels them. Nothing half done is kept : the analyzer is
+	// left empty, as after removeAll(), and errorString() is "Canceled".
+	bool loadJarFile(const QString & jarPath, ProgressListener *listener = NULL);
+	bool collectData(ProgressListener *listener = NULL);
+
+	// The class table of the last collectData() and the map it was made with.
+	// A restored snapshot only needs collectData() to build the reports again.
+	bool saveSnapshot(const QString & snapshotPath) const;
+	bool loadSnapshot(const QString & snapshotPath, const QString & jarPath, const QString & mapPath);
+
+	// report rows, in the order the tables show them before any sort. search() gives rows of classes().
+	QVector<int> search(const SearchFilter &filter) const;
+	QList<const UniqueClassContext*> innerClassReport() const;
+	QList<const PackageContext*> packageReport() const;
+	// references between the classes of the jar, built by collectData()
+	const DependencyGraph &dependencyGraph() const { return graph_; }
+	// classes the last collectData() started the reachability from, 0 if it found none
+	int reachabilityRootCount() const { return reachabilityRootCount_; }
+	// number of classes referencing each symbol, by symbol id, from the reference lists of classes()
+	QVector<int> countReferences() const;
+
+	const ClassTable &classes() const { return classes_; }
+	// names of the classes and of the aggregates, kept as long as the loaded classes
+	const SymbolTable &symbols() const { return symbols_; }
+	// Names of a row, made from the symbol table on each call.
+	// className() is "com.foo.Bar", originalName() the same for the uncrypted name.
+	QString className(int row) const { return symbols_.text(classes_.classId(row)); }
+	QString originalName(int row) const { return symbols_.text(classes_.originalId(row)); }
+	// entry name in its container, "com/foo/Bar.class"
+	QString filePath(int row) const;
+	// file name made of the class name, "com_foo_Bar"
+	QString fullClassNameForKey(int row) const;
+	// jar stored in the analyzed jar holding the row, empty for the analyzed jar itself
+	QString containerPath(int row) const;
+	// Uncompressed bytes of the row's entry. Rows don't keep them : they are read from the
+	// open jar and the most recently used ones are kept until entryCacheSize() bytes are held.
+	QByteArray entryBytes(int row) const;
+	void setEntryCacheSize(int bytes);
+	int entryCacheSize() const { return entryCache_.maxCost(); }
+	// bytes held by the cache now
+	int entryCacheUsed() const { return entryCache_.totalCost(); }
+	const JarReader &jarReader() const { return jarReader_; }
+
+	// jar holding the entry of a row, ClassTable::containerIndex()
+	const JarReader *container(int index) const;
+	int containerCount() const { return nestedJars_.size() + 1; }
+	const QString &mapPath() const { return mapPath_; }
+	QString errorString() const { return errorString_; }
+
+	// statistics of the last loadJarFile()
+	int loadThreadCount() const { return loadThreadCount_; }
+	qint64 loadedBytes() const { return loadedBytes_; }
+	int reusedCount() const { return reusedCount_; }
+
+private:
+	bool cancel();
+	bool openJars(const QString & jarPath);
+	void closeJars();
+	void clearAggregates();
+	void updateReferencedCount();
+	QVector<int> reachabilityRootNodes() const;
+	void markReachableClasses(const QVector<int> &roots, const QVector<PackageContext*> &packageOfClass);
+	void computeRetainedSizes(const QVector<int> &roots, const QVector<PackageContext*> &packageOfClass);
+	void addReferencedCount(const QHash<int, QVector<int> > &rowsById, const QBitArray &addedRows,
+		const QVector<int> &referencedList, int delta);
+
+	JarReader jarReader_;
+	QList<JarReader*> nestedJars_;		// jars stored in jarReader_, container() 1 and up
+	QString mapPath_;
+	SymbolTable symbols_;
+	ClassTable classes_;
+	QVector<int> addedRows_;				// loaded by the last loadJarFile(), not yet counted
+	QVector<QVector<int> > staleReferences_;	// reference lists of the rows replaced or removed by the last loadJarFile()
+	bool collected_;						// classes_ counts are complete
+	QVector<UniqueClassContext*> uniqueClassMap_;	// by symbol id, NULL for the other names
+	QVector<PackageContext*> packageMap_;			// by symbol id, NULL for the other names
+	DependencyGraph graph_;
+	ReachabilityRoots roots_;
+	int reachabilityRootCount_;
+	QMap<QString, QString> proguardMap_VK_;
+	QString errorString_;
+	int loadThreadCount_;
+	qint64 loadedBytes_;
+	int reusedCount_;
+	mutable QCache<qint64, QByteArray> entryCache_;	// by container and entry index, cost is the byte count
+};
+
+#endif // JARANALYZER_H
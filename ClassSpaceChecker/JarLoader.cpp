@@ -0,0 +1,412 @@
+#include "JarLoader.h"
+#include "jclass/jclass.h"
+#include <algorithm>
+
+bool JarLoader::collectJavaClassInfo(const QByteArray & classBuffer, ClassTable &classes, int row, SymbolTable &symbols, JClassArena *arena) 
+{
+	// the constant pool is read in place, only its index arrays are allocated.
+	// Nothing past the buffer is read, a broken class only gets its error recorded.
+	JavaClassView clazz;
+	JClassError error = jclass_class_view_from_buffer(classBuffer.constData(), classBuffer.size(), &clazz, arena);
+	if(error != JCLASS_OK)
+	{
+		classes.setParseError(row, QString("%1 at offset %2").arg(jclass_error_string(error)).arg(clazz.offset));
+		return false;
+	}
+
+	// method count
+	classes.setMethodCount(row, clazz.methods_count);
+	const ConstantPoolView *constant_pool = &clazz.constant_pool;
+
+	uint16_t this_length = 0;
+	const char* this_class = jclass_cpview_get_class_name(constant_pool, constant_pool->this_class, &this_length);
+
+	// the names are interned as they are in the class, all under one lock
+	QVarLengthArray<SymbolName, 256> names;
+	for(int count = 1; count < constant_pool->count; count++)
+	{
+		if(constant_pool->tags[count] != CONSTANT_Class)
+			continue;
+
+		// arrays of primitive types aren't classes
+		uint16_t length;
+		const char* class_name = jclass_cpview_get_class_name(constant_pool, count, &length);
+		if(class_name == NULL)
+			continue;
+
+		if(this_class != NULL && length == this_length && memcmp(class_name, this_class, length) == 0)
+			continue;
+
+		SymbolName name = { class_name, length };
+		names.append(name);
+	}
+
+	QVector<int> ids(names.size());
+	symbols.intern(names.constData(), names.size(), ids.data());
+
+	// a class can be in the constant pool twice, e.g. as "Foo" and as "[LFoo;"
+	qSort(ids);
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+	classes.setReferencedList(row, ids);
+
+	if(arena == NULL)
+		jclass_class_view_free(&clazz);
+
+	return true;
+}
+
+
+// A .class or .java entry found while reading the central directory
+struct JarEntryJob
+{
+	int container;
+	int index;
+	long size;
+	quint32 crc;
+	bool javaFileFlag;
+	QString fileName;
+	QString ext;
+	int cachedRow;		// up to date row of a previous load, nothing to read
+};
+
+// Shared by the loader workers. Entries are handed out in chunks of consecutive
+// indexes and every chunk has its own result table, so appending the tables in chunk
+// order gives the jar order back no matter which thread did the work.
+struct JarLoadState
+{
+	SymbolTable *symbols;
+	const JarReader * const *containers;
+	const ClassTable *cachedClasses;
+	QVector<JarEntryJob> jobs;
+	ClassTable *chunkResults;
+	int chunkCount;
+	int chunkSize;
+	QAtomicInt nextChunk;
+	QAtomicInt doneCount;
+	QAtomicInt canceled;
+};
+
+// Inflates and parses the entries of the chunks it takes. All workers read the
+// same mapping of the jar, or the same memory of a nested jar.
+class JarLoadWorker : public QRunnable
+{
+public:
+	JarLoadWorker(JarLoadState *state) : state_(state), totalBytes_(0)
+	{
+		setAutoDelete(false);
+	}
+
+	qint64 totalBytes() const { return totalBytes_; }
+
+	virtual void run()
+	{
+		// reused for every entry of this thread, so nothing touches the disk while loading
+		QByteArray entryBuffer;
+		// holds the parse of one class at a time, most classes fit in its first block.
+		// Without it the parses fall back to malloc.
+		JClassArena *arena = jclass_arena_new(64 * 1024);
+		const QVector<JarEntryJob> &jobs = state_->jobs;
+
+		for(;;)
+		{
+			int chunk = state_->nextChunk.fetchAndAddOrdered(1);
+			if(chunk >= state_->chunkCount)
+				break;
+
+			int begin = chunk * state_->chunkSize;
+			int end = qMin(begin + state_->chunkSize, jobs.size());
+			ClassTable &results = state_->chunkResults[chunk];
+			results.reserve(end - begin);
+
+			for(int i = begin; i < end; i++)
+			{
+				// once canceled, chunks are still taken to hand the cached items back
+				const JarEntryJob &job = jobs.at(i);
+				if(job.cachedRow < 0 && state_->canceled)
+					continue;
+
+				loadEntry(job, results, entryBuffer, arena);
+				state_->doneCount.fetchAndAddRelaxed(1);
+			}
+		}
+
+		if(arena != NULL)
+			jclass_arena_free(arena);
+	}
+
+private:
+	void loadEntry(const JarEntryJob &job, ClassTable &results, QByteArray &entryBuffer, JClassArena *arena)
+	{
+		if(job.cachedRow >= 0)
+		{
+			int row = results.append(*state_->cachedClasses, job.cachedRow);
+			results.setEntry(row, job.container, job.index);
+			return;
+		}
+
+		// the internal form of the class name, the one the constant pools use
+		QByteArray name = job.fileName.left(job.fileName.length() - job.ext.length()).toUtf8();
+		name.replace('.', '/');
+		int row = results.append(state_->symbols->intern(name), job.container, job.index, job.crc, job.size, job.javaFileFlag);
+
+		// STORED entries come straight from the mapping, only DEFLATE ones use entryBuffer.
+		// The bytes aren't kept, JarAnalyzer::entryBytes() reads them again when needed.
+		const char *data;
+		qint64 size;
+		if( state_->containers[job.container]->read(job.index, &data, &size, entryBuffer) ) 
+		{
+			totalBytes_ += size;
+
+			if(!job.javaFileFlag)
+			{
+				// this infomation is set in collectData() method
+				results.setReferencedCount(row, 0);
+				results.setMethodCount(row, 0);
+
+				JarLoader::collectJavaClassInfo(QByteArray::fromRawData(data, size), results, row, *state_->symbols, arena);
+				if(arena != NULL)
+					jclass_arena_reset(arena);
+			}
+		}
+		else
+		{
+			results.setParseError(row, "Corrupt zip entry");
+		}
+	}
+
+	JarLoadState *state_;
+	qint64 totalBytes_;
+};
+
+
+// A jar stored in one of the jars of the current level
+struct NestedJarJob
+{
+	const JarReader *parent;
+	int index;
+	QString path;
+	JarReader *reader;	// NULL if the entry isn't a readable zip
+};
+
+// Opens the nested jars of one level, one per run. A STORED jar is read in place from
+// its parent, a DEFLATE one is inflated into its own buffer.
+class NestedJarWorker : public QRunnable
+{
+public:
+	NestedJarWorker(NestedJarJob *job) : job_(job)
+	{
+	}
+
+	virtual void run()
+	{
+		QByteArray buffer;
+		const char *data;
+		qint64 size;
+		if( !job_->parent->read(job_->index, &data, &size, buffer) )
+			return;
+
+		QByteArray bytes;
+		if(data == buffer.constData())
+		{
+			buffer.resize(size);
+			bytes = buffer;
+		}
+		else
+		{
+			bytes = QByteArray::fromRawData(data, size);
+		}
+
+		JarReader *reader = new JarReader();
+		reader->setInflateBackend(job_->parent->inflateBackend());
+		if( !reader->open(bytes, job_->path) )
+		{
+			delete reader;
+			return;
+		}
+		job_->reader = reader;
+	}
+
+private:
+	NestedJarJob *job_;
+};
+
+
+JarLoader::JarLoader(const JarReader &reader, SymbolTable &symbols, const QList<JarReader*> &nestedJars) : symbols_(symbols), maxThreadCount_(0), threadCount_(0), totalBytes_(0), reusedCount_(0), canceled_(false)
+{
+	containers_.append(&reader);
+	containerPaths_.append(QString());
+	for( int i = 0; i < nestedJars.size(); i++ )
+	{
+		containers_.append(nestedJars.at(i));
+		containerPaths_.append(nestedJars.at(i)->path());
+	}
+}
+
+QString JarLoader::cacheKey(const QString &containerPath, const QString &filePath)
+{
+	if(containerPath.isEmpty())
+		return filePath;
+	return containerPath + "!/" + filePath;
+}
+
+void JarLoader::openNestedJars(const JarReader &reader, QList<JarReader*> &nestedJars)
+{
+	QList<const JarReader*> level;
+	QList<QString> levelPaths;
+	level.append(&reader);
+	levelPaths.append(QString());
+
+	while(!level.isEmpty())
+	{
+		QVector<NestedJarJob> jobs;
+		for( int i = 0; i < level.size(); i++ )
+		{
+			const JarReader *parent = level.at(i);
+			for( int j = 0; j < parent->count(); j++ )
+			{
+				const QString &name = parent->entry(j).name;
+				if(!name.endsWith(".jar", Qt::CaseInsensitive))
+					continue;
+
+				NestedJarJob job;
+				job.parent = parent;
+				job.index = j;
+				job.path = cacheKey(levelPaths.at(i), name);
+				job.reader = NULL;
+				jobs.append(job);
+			}
+		}
+
+		if(jobs.isEmpty())
+			break;
+
+		QThreadPool pool;
+		pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount(), jobs.size()));
+		for( int i = 0; i < jobs.size(); i++ )
+			pool.start(new NestedJarWorker(&jobs[i]));
+		pool.waitForDone();
+
+		level.clear();
+		levelPaths.clear();
+		for( int i = 0; i < jobs.size(); i++ )
+		{
+			if(jobs[i].reader == NULL)
+				continue;
+			nestedJars.append(jobs[i].reader);
+			level.append(jobs[i].reader);
+			levelPaths.append(jobs[i].path);
+		}
+	}
+}
+
+void JarLoader::load(ClassTable &classes, ProgressListener *listener,
+	const ClassTable *cachedClasses, QHash<QString, int> *cache)
+{
+	threadCount_ = 0;
+	totalBytes_ = 0;
+	reusedCount_ = 0;
+	canceled_ = false;
+	loadedRows_.clear();
+
+	JarLoadState state;
+	state.symbols = &symbols_;
+	state.containers = containers_.data();
+	state.cachedClasses = cachedClasses;
+
+	// central directory pass : pick up the entries to load, in jar order, container after container
+	for( int c = 0; c < containers_.size(); c++ )
+	{
+		const JarReader &reader = *containers_.at(c);
+		int numitems = reader.count();
+		for( int i = 0; i < numitems; i++ )
+		{ 
+			const JarEntry &ze = reader.entry(i);
+
+			JarEntryJob job;
+			job.container = c;
+			job.index = i;
+			job.size = (long)ze.uncompressedSize;
+			job.crc = ze.crc;
+			job.fileName = ze.name;
+			job.cachedRow = -1;
+			job.javaFileFlag = false;
+			job.ext = ".class";
+			int pos = job.fileName.indexOf(job.ext, Qt::CaseInsensitive);
+			if(pos != (job.fileName.length() - job.ext.length()))
+			{
+				job.ext = ".java";
+				pos = job.fileName.indexOf(job.ext, Qt::CaseInsensitive);
+				if(pos != (job.fileName.length() - job.ext.length()))
+				{
+					continue;
+				}
+				job.javaFileFlag = true;
+			}
+
+			// the central directory already tells if the entry changed since the cached row was loaded
+			if(cache != NULL)
+			{
+				QHash<QString, int>::iterator it = cache->find(cacheKey(containerPaths_.at(c), job.fileName));
+				if(it != cache->end() && cachedClasses->crc(it.value()) == job.crc && cachedClasses->fileSize(it.value()) == job.size)
+				{
+					job.cachedRow = it.value();
+					cache->erase(it);
+					reusedCount_++;
+				}
+			}
+			state.jobs.append(job);
+		}
+	}
+
+	if(state.jobs.isEmpty())
+		return;
+
+	// small chunks keep every thread busy until the end, even when a few classes are huge
+	state.chunkSize = 64;
+	state.chunkCount = (state.jobs.size() + state.chunkSize - 1) / state.chunkSize;
+	QVector<ClassTable> chunkResults(state.chunkCount);
+	state.chunkResults = chunkResults.data();
+
+	threadCount_ = qBound(1, maxThreadCount_ > 0 ? maxThreadCount_ : QThread::idealThreadCount(), state.chunkCount);
+	QList<JarLoadWorker*> workers;
+	for( int i = 0; i < threadCount_; i++ )
+		workers.append(new JarLoadWorker(&state));
+
+	QThreadPool pool;
+	pool.setMaxThreadCount(workers.size());
+	for( int i = 0; i < workers.size(); i++ )
+		pool.start(workers[i]);
+
+	while(!pool.waitForDone(50))
+	{
+		if(listener == NULL)
+			continue;
+		listener->onProgress(state.doneCount, state.jobs.size());
+		if(listener->isCanceled())
+			state.canceled = 1;
+	}
+	canceled_ = (state.canceled != 0);
+	if(listener != NULL && !canceled_)
+		listener->onProgress(state.jobs.size(), state.jobs.size());
+
+	for( int i = 0; i < workers.size(); i++ )
+	{
+		totalBytes_ += workers[i]->totalBytes();
+		delete workers[i];
+	}
+
+	int firstRow = classes.size();
+	classes.reserve(firstRow + state.jobs.size());
+	for( int i = 0; i < state.chunkCount; i++ )
+		classes.append(chunkResults[i]);
+
+	// every job has its row when nothing was canceled
+	if(!canceled_)
+	{
+		for( int i = 0; i < state.jobs.size(); i++ )
+		{
+			if(state.jobs.at(i).cachedRow < 0)
+				loadedRows_.append(firstRow + i);
+		}
+	}
+}
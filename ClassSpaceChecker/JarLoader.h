@@ -0,0 +1,76 @@
+#ifndef JARLOADER_H
+#define JARLOADER_H
+
+#include <QtCore>
+#include "XZip/JarReader.h"
+#include "ClassTable.h"
+#include "SymbolTable.h"
+
+struct JClassArena;
+
+class ProgressListener
+{
+public:
+	virtual ~ProgressListener() {}
+
+	// called from the thread running the work (JarLoader::load(), JarAnalyzer::collectData(), ...)
+	virtual void onProgress(int done, int total) = 0;
+
+	// polled by the same work, often enough to stop it within a few ms once it returns true
+	virtual bool isCanceled() const { return false; }
+};
+
+// Turns the .class and .java entries of an opened jar into ClassTable rows.
+// Only depends on QtCore, so the same data comes out on every platform.
+class JarLoader
+{
+public:
+	// the classes of nestedJars (see openNestedJars()) are loaded after the ones of reader.
+	// The names of the loaded rows are interned in symbols.
+	JarLoader(const JarReader &reader, SymbolTable &symbols, const QList<JarReader*> &nestedJars = QList<JarReader*>());
+
+	// Opens the jars stored in reader (Spring Boot BOOT-INF/lib, AAR classes.jar and libs, shaded
+	// jars, ...) and the ones stored in those, from their bytes in memory. The jars of one level are
+	// opened on all cores. They are appended to nestedJars, parents first, and owned by the caller.
+	// The path() of a nested jar is its path inside reader, "a.jar!/b.jar" for a jar stored in a.jar.
+	static void openNestedJars(const JarReader &reader, QList<JarReader*> &nestedJars);
+
+	// Appends one row per entry to classes, in jar order.
+	// Entries are inflated and parsed on all cores, load() returns when they're all done.
+	// A row of cachedClasses, found in cache by cacheKey(), whose crc and size match the entry
+	// is copied to classes instead of loading the entry again and taken out of cache : what is
+	// left there is out of date.
+	// When the listener cancels, the entries left aren't read : canceled() is true and
+	// classes only holds complete rows for the entries loaded so far and the cached ones.
+	void load(ClassTable &classes, ProgressListener *listener = NULL,
+		const ClassTable *cachedClasses = NULL, QHash<QString, int> *cache = NULL);
+
+	// workers of the next load(), QThread::idealThreadCount() when 0 (e.g. to measure the scaling)
+	void setMaxThreadCount(int count) { maxThreadCount_ = count; }
+	int threadCount() const { return threadCount_; }
+	qint64 totalBytes() const { return totalBytes_; }
+	int reusedCount() const { return reusedCount_; }
+	bool canceled() const { return canceled_; }
+	// rows of the last load() read from the jar rather than copied from the cache
+	const QVector<int> &loadedRows() const { return loadedRows_; }
+
+	// key of a row in the cache given to load()
+	static QString cacheKey(const QString &containerPath, const QString &filePath);
+
+	// thread safe, called by the loader workers. classBuffer only has to live during the call.
+	// With an arena, the parse is allocated from it and left there for the caller to reset.
+	static bool collectJavaClassInfo(const QByteArray & classBuffer, ClassTable &classes, int row, SymbolTable &symbols, JClassArena *arena = NULL);
+
+private:
+	SymbolTable &symbols_;
+	QVector<const JarReader*> containers_;
+	QVector<QString> containerPaths_;
+	int maxThreadCount_;
+	int threadCount_;
+	qint64 totalBytes_;
+	int reusedCount_;
+	bool canceled_;
+	QVector<int> loadedRows_;
+};
+
+#endif // JARLOADER_H
@@ -164,6 +164,13 @@ public:
 		return CPresetData();
 	}
 
+	// analysis snapshot of a preset, next to the ini file
+	QString getSnapshotPath(const QString &id)
+	{
+		QFileInfo info(INI_FILE_);
+		return info.absolutePath() + QDir::separator() + info.completeBaseName() + "_" + id + ".snapshot";
+	}
+
 	CPresetData getPresetDataWithId(const QString &id)
 	{
 		QList<CPresetData> list = getPresetList();
@@ -0,0 +1,142 @@
+#include "SymbolTable.h"
+
+#define SYMBOL_BLOCK_SIZE		(64 * 1024)
+
+// FNV-1a
+static inline uint hashName(const char *name, int length)
+{
+	uint hash = 2166136261u;
+	for(int i = 0; i < length; i++)
+	{
+		hash ^= (uchar)name[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+
+SymbolTable::SymbolTable() : blockUsed_(SYMBOL_BLOCK_SIZE), blockBytes_(0)
+{
+}
+
+SymbolTable::~SymbolTable()
+{
+	clear();
+}
+
+void SymbolTable::clear()
+{
+	for(int i = 0; i < blocks_.size(); i++)
+		free(blocks_[i]);
+	blocks_.clear();
+	blockUsed_ = SYMBOL_BLOCK_SIZE;
+	blockBytes_ = 0;
+
+	names_.clear();
+	lengths_.clear();
+	hashes_.clear();
+	buckets_.clear();
+}
+
+int SymbolTable::intern(const char *name, int length)
+{
+	uint hash = hashName(name, length);
+	QMutexLocker locker(&mutex_);
+	return insert(name, length, hash);
+}
+
+void SymbolTable::intern(const SymbolName *names, int count, int *ids)
+{
+	// hashed before taking the lock, only the lookups are serialized
+	QVarLengthArray<uint, 64> hashes(count);
+	for(int i = 0; i < count; i++)
+		hashes[i] = hashName(names[i].data, names[i].length);
+
+	QMutexLocker locker(&mutex_);
+	for(int i = 0; i < count; i++)
+		ids[i] = insert(names[i].data, names[i].length, hashes[i]);
+}
+
+int SymbolTable::find(const char *name, int length) const
+{
+	return lookup(name, length, hashName(name, length));
+}
+
+QString SymbolTable::text(int id) const
+{
+	QString text = QString::fromUtf8(names_.at(id), lengths_.at(id));
+	text.replace('/', '.');
+	return text;
+}
+
+qint64 SymbolTable::memoryUsage() const
+{
+	return blockBytes_
+		+ names_.capacity() * sizeof(const char*) + lengths_.capacity() * sizeof(int)
+		+ hashes_.capacity() * sizeof(uint) + buckets_.capacity() * sizeof(int);
+}
+
+int SymbolTable::lookup(const char *name, int length, uint hash) const
+{
+	if(buckets_.isEmpty())
+		return -1;
+
+	int mask = buckets_.size() - 1;
+	for(int i = hash & mask; ; i = (i + 1) & mask)
+	{
+		int id = buckets_.at(i);
+		if(id < 0)
+			return -1;
+		if(hashes_.at(id) == hash && lengths_.at(id) == length && memcmp(names_.at(id), name, length) == 0)
+			return id;
+	}
+}
+
+int SymbolTable::insert(const char *name, int length, uint hash)
+{
+	int id = lookup(name, length, hash);
+	if(id >= 0)
+		return id;
+
+	// kept at most half full
+	if((names_.size() + 1) * 2 > buckets_.size())
+		rehash(qMax(1024, buckets_.size() * 2));
+
+	// a name longer than a block gets a block of its own, an empty name still needs the first one
+	if(blocks_.isEmpty() || blockUsed_ + length > SYMBOL_BLOCK_SIZE)
+	{
+		int size = qMax(length, SYMBOL_BLOCK_SIZE);
+		blocks_.append((char *)malloc(size));
+		blockBytes_ += size;
+		blockUsed_ = 0;
+	}
+	char *copy = blocks_.last() + blockUsed_;
+	memcpy(copy, name, length);
+	blockUsed_ += length;
+
+	id = names_.size();
+	names_.append(copy);
+	lengths_.append(length);
+	hashes_.append(hash);
+
+	int mask = buckets_.size() - 1;
+	int i = hash & mask;
+	while(buckets_.at(i) >= 0)
+		i = (i + 1) & mask;
+	buckets_[i] = id;
+	return id;
+}
+
+void SymbolTable::rehash(int bucketCount)
+{
+	buckets_.fill(-1, bucketCount);
+
+	int mask = bucketCount - 1;
+	for(int id = 0; id < hashes_.size(); id++)
+	{
+		int i = hashes_.at(id) & mask;
+		while(buckets_.at(i) >= 0)
+			i = (i + 1) & mask;
+		buckets_[i] = id;
+	}
+}
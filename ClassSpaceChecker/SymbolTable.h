@@ -0,0 +1,60 @@
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <QtCore>
+
+// A name to intern, e.g. straight from the constant pool of a class
+struct SymbolName
+{
+	const char *data;
+	int length;
+};
+
+// Jar wide table of the class and package names. Every distinct name is stored once, as the
+// UTF-8 bytes of its internal form ("java/lang/String"), and gets a dense id from 0 up, so the
+// analysis works on ints rather than on strings.
+// intern() can be called from several threads at once, the other methods can't run at the same
+// time as an intern().
+class SymbolTable
+{
+public:
+	SymbolTable();
+	~SymbolTable();
+
+	// id of the name, added the first time it's seen
+	int intern(const char *name, int length);
+	int intern(const QByteArray &name) { return intern(name.constData(), name.size()); }
+	// one lock for count names, ids receives their ids
+	void intern(const SymbolName *names, int count, int *ids);
+
+	// -1 if the name was never interned
+	int find(const char *name, int length) const;
+
+	int count() const { return names_.size(); }
+	const char *name(int id) const { return names_.at(id); }
+	int length(int id) const { return lengths_.at(id); }
+	QByteArray bytes(int id) const { return QByteArray(names_.at(id), lengths_.at(id)); }
+	// the name decoded, '/' turned into '.' as the reports show it
+	QString text(int id) const;
+
+	// bytes held by the names and the index
+	qint64 memoryUsage() const;
+
+	void clear();
+
+private:
+	int insert(const char *name, int length, uint hash);
+	int lookup(const char *name, int length, uint hash) const;
+	void rehash(int bucketCount);
+
+	QMutex mutex_;
+	QVector<char*> blocks_;			// the name bytes, a block never moves once allocated
+	int blockUsed_;					// bytes used in the last block
+	qint64 blockBytes_;
+	QVector<const char*> names_;
+	QVector<int> lengths_;
+	QVector<uint> hashes_;
+	QVector<int> buckets_;			// open addressing on hashes_, -1 for an empty bucket
+};
+
+#endif // SYMBOLTABLE_H
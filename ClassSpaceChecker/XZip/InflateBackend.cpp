@@ -0,0 +1,120 @@
+#include "InflateBackend.h"
+#include "XInflate.h"
+
+#if defined(JAR_INFLATE_ZLIB)
+#include <zlib.h>
+#endif
+
+#if defined(JAR_INFLATE_LIBDEFLATE)
+#include <libdeflate.h>
+#endif
+
+
+// 1990s zlib 1.1.3 from XUnzip.cpp, always there
+class EmbeddedInflateBackend : public InflateBackend
+{
+public:
+	virtual const char *name() const { return "embedded"; }
+
+	virtual bool inflate(const uchar *src, qint64 srcLen, uchar *dst, qint64 dstLen) const
+	{
+		return XInflateRaw(src, (unsigned long)srcLen, dst, (unsigned long)dstLen) == XINFLATE_OK;
+	}
+};
+
+
+#if defined(JAR_INFLATE_ZLIB)
+
+class ZlibInflateBackend : public InflateBackend
+{
+public:
+	virtual const char *name() const { return "zlib " ZLIB_VERSION; }
+
+	virtual bool inflate(const uchar *src, qint64 srcLen, uchar *dst, qint64 dstLen) const
+	{
+		z_stream stream;
+		memset(&stream, 0, sizeof(stream));
+		// negative window bits : raw deflate, no zlib header
+		if(inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+			return false;
+
+		stream.next_in = (Bytef *)src;
+		stream.avail_in = (uInt)srcLen;
+		stream.next_out = (Bytef *)dst;
+		stream.avail_out = (uInt)dstLen;
+
+		int res = ::inflate(&stream, Z_FINISH);
+		qint64 total = stream.total_out;
+		inflateEnd(&stream);
+
+		// Z_BUF_ERROR with a full output is a stream without its final block marker read
+		return (res == Z_STREAM_END || res == Z_BUF_ERROR) && total == dstLen;
+	}
+};
+
+#endif
+
+
+#if defined(JAR_INFLATE_LIBDEFLATE)
+
+// libdeflate decompresses a whole buffer at once, which is the case of every jar entry.
+// A decompressor can't be shared between threads, each thread gets its own.
+class LibdeflateInflateBackend : public InflateBackend
+{
+public:
+	virtual const char *name() const { return "libdeflate"; }
+
+	virtual bool inflate(const uchar *src, qint64 srcLen, uchar *dst, qint64 dstLen) const
+	{
+		if(!decompressor_.hasLocalData())
+			decompressor_.setLocalData(new Decompressor());
+
+		struct libdeflate_decompressor *d = decompressor_.localData()->d;
+		if(d == NULL)
+			return false;
+
+		// no actual size asked : anything else than exactly dstLen bytes is an error
+		return libdeflate_deflate_decompress(d, src, (size_t)srcLen, dst, (size_t)dstLen, NULL) == LIBDEFLATE_SUCCESS;
+	}
+
+private:
+	struct Decompressor
+	{
+		Decompressor() : d(libdeflate_alloc_decompressor()) {}
+		~Decompressor() { if(d != NULL) libdeflate_free_decompressor(d); }
+		struct libdeflate_decompressor *d;
+	};
+
+	mutable QThreadStorage<Decompressor *> decompressor_;
+};
+
+#endif
+
+
+// built at load time, so there's no lazy initialisation race between the loader threads
+static EmbeddedInflateBackend embeddedBackend;
+#if defined(JAR_INFLATE_ZLIB)
+static ZlibInflateBackend zlibBackend;
+#endif
+#if defined(JAR_INFLATE_LIBDEFLATE)
+static LibdeflateInflateBackend libdeflateBackend;
+#endif
+
+
+const InflateBackend *InflateBackend::defaultBackend()
+{
+	return backends().first();
+}
+
+QList<const InflateBackend *> InflateBackend::backends()
+{
+	QList<const InflateBackend *> list;
+#if defined(JAR_INFLATE_LIBDEFLATE)
+	list.append(&libdeflateBackend);
+#endif
+#if defined(JAR_INFLATE_ZLIB)
+	list.append(&zlibBackend);
+#endif
+	list.append(&embeddedBackend);
+	return list;
+}
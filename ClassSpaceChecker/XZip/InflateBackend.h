@@ -0,0 +1,27 @@
+#ifndef INFLATEBACKEND_H
+#define INFLATEBACKEND_H
+
+#include <QtCore>
+
+// Inflates the whole raw deflate stream of a zip entry in one call, the uncompressed size
+// being known from the central directory.
+// The inflater embedded in XUnzip.cpp is always built. Faster ones are built in when the
+// project defines JAR_INFLATE_ZLIB (system zlib or zlib-ng in compat mode) or
+// JAR_INFLATE_LIBDEFLATE and links the matching library, the fastest one becoming the default.
+class InflateBackend
+{
+public:
+	virtual ~InflateBackend() {}
+
+	virtual const char *name() const = 0;
+
+	// true if dst holds exactly dstLen inflated bytes. Thread safe.
+	virtual bool inflate(const uchar *src, qint64 srcLen, uchar *dst, qint64 dstLen) const = 0;
+
+	static const InflateBackend *defaultBackend();
+
+	// every backend built in, fastest first (for benchmarks)
+	static QList<const InflateBackend *> backends();
+};
+
+#endif // INFLATEBACKEND_H
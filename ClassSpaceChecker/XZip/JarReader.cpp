@@ -0,0 +1,331 @@
+#include "JarReader.h"
+#include <limits.h>
+
+#define SIZE_END_OF_CENTRAL_DIR		22
+#define SIZE_CENTRAL_DIR_ITEM		46
+#define SIZE_LOCAL_HEADER			30
+#define SIZE_ZIP64_END_LOCATOR		20
+#define SIZE_ZIP64_END_OF_CENTRAL_DIR	56
+
+#define SIGNATURE_END_OF_CENTRAL_DIR	0x06054b50
+#define SIGNATURE_CENTRAL_DIR_ITEM		0x02014b50
+#define SIGNATURE_LOCAL_HEADER			0x04034b50
+#define SIGNATURE_ZIP64_END_LOCATOR		0x07064b50
+#define SIGNATURE_ZIP64_END_OF_CENTRAL_DIR	0x06064b50
+
+#define EXTRA_ZIP64			0x0001
+
+#define METHOD_STORED		0
+#define METHOD_DEFLATED		8
+
+#define FLAG_UTF8_NAME		0x0800
+
+static inline quint16 readLE16(const uchar *p)
+{
+	return (quint16)(p[0] | (p[1] << 8));
+}
+
+static inline quint32 readLE32(const uchar *p)
+{
+	return (quint32)p[0] | ((quint32)p[1] << 8) | ((quint32)p[2] << 16) | ((quint32)p[3] << 24);
+}
+
+static inline quint64 readLE64(const uchar *p)
+{
+	return (quint64)readLE32(p) | ((quint64)readLE32(p + 4) << 32);
+}
+
+// Replaces the 32 bit fields saturated to 0xffffffff by their value in the zip64 extra field.
+// The extra field only holds the saturated ones, in this order.
+static bool readZip64Extra(const uchar *extra, int extraLength, JarEntry &e)
+{
+	const uchar *end = extra + extraLength;
+	while(extra + 4 <= end)
+	{
+		int id = readLE16(extra);
+		int size = readLE16(extra + 2);
+		const uchar *p = extra + 4;
+		const uchar *next = p + size;
+		if(next > end)
+			return false;
+
+		if(id == EXTRA_ZIP64)
+		{
+			qint64 *fields[] = { &e.uncompressedSize, &e.compressedSize, &e.localHeaderOffset };
+			for(int i = 0; i < 3; i++)
+			{
+				if(*fields[i] != 0xffffffff)
+					continue;
+				if(p + 8 > next)
+					return false;
+				*fields[i] = (qint64)readLE64(p);
+				p += 8;
+			}
+			return true;
+		}
+		extra = next;
+	}
+	return true;
+}
+
+
+JarReader::JarReader() : data_(NULL), size_(0), prefixSize_(0), inflateBackend_(InflateBackend::defaultBackend())
+{
+}
+
+JarReader::~JarReader()
+{
+	close();
+}
+
+bool JarReader::open(const QString &path)
+{
+	close();
+
+	file_.setFileName(path);
+	if(!file_.open(QIODevice::ReadOnly))
+	{
+		errorString_ = file_.errorString();
+		return false;
+	}
+
+	size_ = file_.size();
+	data_ = file_.map(0, size_);
+	if(data_ == NULL)
+	{
+		errorString_ = file_.errorString();
+		close();
+		return false;
+	}
+	path_ = path;
+
+	if(!parseCentralDirectory())
+	{
+		QString error = errorString_;
+		close();
+		errorString_ = error;
+		return false;
+	}
+	return true;
+}
+
+bool JarReader::open(const QByteArray &bytes, const QString &path)
+{
+	close();
+
+	bytes_ = bytes;
+	data_ = (const uchar *)bytes_.constData();
+	size_ = bytes_.size();
+	path_ = path;
+
+	if(!parseCentralDirectory())
+	{
+		QString error = errorString_;
+		close();
+		errorString_ = error;
+		return false;
+	}
+	return true;
+}
+
+void JarReader::close()
+{
+	if(data_ != NULL && file_.isOpen())
+		file_.unmap(const_cast<uchar *>(data_));
+	file_.close();
+	bytes_.clear();
+	path_.clear();
+
+	data_ = NULL;
+	size_ = 0;
+	prefixSize_ = 0;
+	entries_.clear();
+	nameIndex_.clear();
+	errorString_.clear();
+}
+
+bool JarReader::parseCentralDirectory()
+{
+	if(size_ < SIZE_END_OF_CENTRAL_DIR)
+	{
+		errorString_ = "Not a zip file";
+		return false;
+	}
+
+	// the end of central dir record is followed by a comment of at most 64 KB
+	qint64 eocd = -1;
+	qint64 lowest = qMax((qint64)0, size_ - SIZE_END_OF_CENTRAL_DIR - 0xffff);
+	for(qint64 pos = size_ - SIZE_END_OF_CENTRAL_DIR; pos >= lowest; pos--)
+	{
+		if(readLE32(data_ + pos) == SIGNATURE_END_OF_CENTRAL_DIR)
+		{
+			eocd = pos;
+			break;
+		}
+	}
+	if(eocd < 0)
+	{
+		errorString_ = "End of central directory not found";
+		return false;
+	}
+
+	const uchar *p = data_ + eocd;
+	qint64 entryCount = readLE16(p + 10);
+	qint64 dirSize = readLE32(p + 12);
+	qint64 dirOffset = readLE32(p + 16);
+	qint64 dirEndPos = eocd;
+
+	// past 65535 entries or 4 GB the real values are in the zip64 end record, found through
+	// the locator right before the classic one
+	qint64 locator = eocd - SIZE_ZIP64_END_LOCATOR;
+	if(locator >= 0 && readLE32(data_ + locator) == SIGNATURE_ZIP64_END_LOCATOR)
+	{
+		// the recorded offset doesn't account for a prefix, the record normally sits right before the locator
+		qint64 eocd64 = (qint64)readLE64(data_ + locator + 8);
+		if(eocd64 < 0 || eocd64 > locator - SIZE_ZIP64_END_OF_CENTRAL_DIR
+			|| readLE32(data_ + eocd64) != SIGNATURE_ZIP64_END_OF_CENTRAL_DIR)
+			eocd64 = locator - SIZE_ZIP64_END_OF_CENTRAL_DIR;
+		if(eocd64 < 0 || readLE32(data_ + eocd64) != SIGNATURE_ZIP64_END_OF_CENTRAL_DIR)
+		{
+			errorString_ = "Zip64 end of central directory not found";
+			return false;
+		}
+
+		p = data_ + eocd64;
+		entryCount = (qint64)readLE64(p + 32);
+		dirSize = (qint64)readLE64(p + 40);
+		dirOffset = (qint64)readLE64(p + 48);
+		dirEndPos = eocd64;
+	}
+
+	// the central dir sits right before its end record, whatever is in front of the zip
+	qint64 dirPos = dirEndPos - dirSize;
+	if(dirSize < 0 || dirOffset < 0 || dirPos < 0 || dirPos < dirOffset)
+	{
+		errorString_ = "Bad central directory";
+		return false;
+	}
+	prefixSize_ = dirPos - dirOffset;
+
+	// the count is only a hint: some tools wrap it past 65535 entries without writing zip64 records,
+	// so the directory is walked to its end
+	int reserved = (int)qMin(entryCount, dirSize / SIZE_CENTRAL_DIR_ITEM);
+	entries_.reserve(reserved);
+	nameIndex_.reserve(reserved);
+
+	const uchar *dirEnd = data_ + dirPos + dirSize;
+	p = data_ + dirPos;
+	while(p < dirEnd)
+	{
+		if(p + SIZE_CENTRAL_DIR_ITEM > dirEnd || readLE32(p) != SIGNATURE_CENTRAL_DIR_ITEM)
+		{
+			errorString_ = "Bad central directory";
+			return false;
+		}
+
+		quint16 flags = readLE16(p + 8);
+		int nameLength = readLE16(p + 28);
+		int extraLength = readLE16(p + 30);
+		int commentLength = readLE16(p + 32);
+		const uchar *next = p + SIZE_CENTRAL_DIR_ITEM + nameLength + extraLength + commentLength;
+		if(next > dirEnd)
+		{
+			errorString_ = "Bad central directory";
+			return false;
+		}
+
+		JarEntry e;
+		const char *name = (const char *)p + SIZE_CENTRAL_DIR_ITEM;
+		e.name = (flags & FLAG_UTF8_NAME) ? QString::fromUtf8(name, nameLength) : QString::fromLocal8Bit(name, nameLength);
+		e.method = readLE16(p + 10);
+		e.crc = readLE32(p + 16);
+		e.compressedSize = readLE32(p + 20);
+		e.uncompressedSize = readLE32(p + 24);
+		e.localHeaderOffset = readLE32(p + 42);
+		if(!readZip64Extra(p + SIZE_CENTRAL_DIR_ITEM + nameLength, extraLength, e))
+		{
+			errorString_ = "Bad zip64 extra field";
+			return false;
+		}
+
+		if(!nameIndex_.contains(e.name))
+			nameIndex_.insert(e.name, entries_.size());
+		entries_.append(e);
+
+		p = next;
+	}
+	return true;
+}
+
+// Start of the entry data, right after its local header. NULL if it doesn't fit in the file.
+const uchar *JarReader::entryData(const JarEntry &e) const
+{
+	qint64 pos = prefixSize_ + e.localHeaderOffset;
+	if(pos < 0 || pos + SIZE_LOCAL_HEADER > size_)
+		return NULL;
+
+	const uchar *p = data_ + pos;
+	if(readLE32(p) != SIGNATURE_LOCAL_HEADER)
+		return NULL;
+
+	// name and extra field can differ from the central dir ones, sizes are taken from there
+	pos += SIZE_LOCAL_HEADER + readLE16(p + 26) + readLE16(p + 28);
+	if(e.compressedSize < 0 || pos + e.compressedSize > size_)
+		return NULL;
+
+	return data_ + pos;
+}
+
+bool JarReader::read(int index, const char **data, qint64 *size, QByteArray &buffer) const
+{
+	if(!isOpen() || index < 0 || index >= entries_.size())
+		return false;
+
+	const JarEntry &e = entries_.at(index);
+	// the jar can be over 4 GB, a single entry still has to fit in a QByteArray
+	if(e.uncompressedSize > INT_MAX || e.compressedSize > INT_MAX)
+		return false;
+
+	const uchar *src = entryData(e);
+	if(src == NULL)
+		return false;
+
+	if(e.method == METHOD_STORED)
+	{
+		if(e.compressedSize != e.uncompressedSize)
+			return false;
+
+		*data = (const char *)src;
+		*size = e.uncompressedSize;
+		return true;
+	}
+
+	if(e.method != METHOD_DEFLATED)
+		return false;
+
+	if(buffer.size() < e.uncompressedSize)
+		buffer.resize(e.uncompressedSize);
+
+	if(!inflateBackend_->inflate(src, e.compressedSize, (uchar *)buffer.data(), e.uncompressedSize))
+		return false;
+
+	*data = buffer.constData();
+	*size = e.uncompressedSize;
+	return true;
+}
+
+QByteArray JarReader::read(int index) const
+{
+	QByteArray buffer;
+	const char *data;
+	qint64 size;
+	if(!read(index, &data, &size, buffer))
+		return QByteArray();
+
+	if(data == buffer.constData())
+	{
+		buffer.resize(size);
+		return buffer;
+	}
+	return QByteArray(data, size);
+}
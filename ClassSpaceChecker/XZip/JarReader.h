@@ -0,0 +1,71 @@
+#ifndef JARREADER_H
+#define JARREADER_H
+
+#include <QtCore>
+#include "InflateBackend.h"
+
+// One record of the central directory
+struct JarEntry
+{
+	QString name;
+	quint16 method;
+	quint32 crc;
+	qint64 compressedSize;
+	qint64 uncompressedSize;
+	qint64 localHeaderOffset;
+};
+
+// Read only zip reader working on a memory mapping of the jar.
+// The central directory is parsed in place when the jar is opened, STORED entries are
+// handed out as views into the mapping and DEFLATE entries are inflated straight from it.
+// Once opened, every const method can be called from several threads at once.
+// Zip64 jars (more than 65535 entries or over 4 GB) are read as well, the whole file must
+// fit in the address space though, which a 32 bit build can't offer for a jar close to 4 GB.
+class JarReader
+{
+public:
+	JarReader();
+	~JarReader();
+
+	bool open(const QString &path);
+	// Opens a jar held in memory, e.g. the bytes of a jar stored in another jar.
+	// bytes must stay unchanged while the reader is open, path is only reported by path().
+	bool open(const QByteArray &bytes, const QString &path);
+	void close();
+
+	bool isOpen() const { return data_ != NULL; }
+	QString path() const { return path_; }
+	QString errorString() const { return errorString_; }
+
+	int count() const { return entries_.size(); }
+	const JarEntry &entry(int index) const { return entries_.at(index); }
+	int find(const QString &name) const { return nameIndex_.value(name, -1); }
+
+	// InflateBackend::defaultBackend() unless changed, e.g. to compare backends
+	const InflateBackend *inflateBackend() const { return inflateBackend_; }
+	void setInflateBackend(const InflateBackend *backend) { inflateBackend_ = backend; }
+
+	// Uncompressed bytes of an entry. For a STORED entry *data points into the mapping and
+	// buffer isn't touched, a DEFLATE entry is inflated into buffer (grown only if needed).
+	bool read(int index, const char **data, qint64 *size, QByteArray &buffer) const;
+
+	// Same as above, returned as an owned copy
+	QByteArray read(int index) const;
+
+private:
+	bool parseCentralDirectory();
+	const uchar *entryData(const JarEntry &e) const;
+
+	QFile file_;
+	QByteArray bytes_;		// the jar opened from memory
+	QString path_;
+	const uchar *data_;
+	qint64 size_;
+	qint64 prefixSize_;		// bytes in front of the zip data (self extracting stub, ...)
+	const InflateBackend *inflateBackend_;
+	QVector<JarEntry> entries_;
+	QHash<QString, int> nameIndex_;
+	QString errorString_;
+};
+
+#endif // JARREADER_H
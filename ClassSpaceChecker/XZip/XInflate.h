@@ -0,0 +1,37 @@
+// XInflate.h
+//
+// Portable entry point into the inflater embedded in XUnzip.cpp. Unlike the
+// OpenZip()/UnzipItem() API it has no Win32 dependency, it is meant for readers
+// that already hold the compressed bytes of a zip entry in memory (JarReader).
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef XINFLATE_H
+#define XINFLATE_H
+
+// return codes of XInflateRaw()
+#define XINFLATE_OK       0
+#define XINFLATE_DATA    (-1)    // the deflate stream is corrupt
+#define XINFLATE_SIZE    (-2)    // the stream doesn't inflate to exactly dstLen bytes
+#define XINFLATE_MEMORY  (-3)    // couldn't allocate the inflate state
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// XInflateRaw()
+//
+// Purpose:     Inflate a whole raw deflate stream (no zlib header, as stored in
+//              zip entries) in one call
+//
+// Parameters:  src    - compressed bytes
+//              srcLen - number of compressed bytes
+//              dst    - output buffer
+//              dstLen - uncompressed size, as found in the central directory
+//
+// Returns:     int    - XINFLATE_OK if dst holds the dstLen inflated bytes
+//
+// Notes:       Thread safe, every call has its own inflate state.
+//
+int XInflateRaw(const unsigned char *src, unsigned long srcLen,
+                unsigned char *dst, unsigned long dstLen);
+
+#endif //XINFLATE_H
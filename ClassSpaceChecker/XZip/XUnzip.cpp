@@ -94,15 +94,22 @@
 #define _USE_32BIT_TIME_T	//+++1.2
 
 
+// Only the zip file API below needs Win32. The inflater itself is portable and
+// is reached through XInflate.h on every platform.
+#ifdef _WIN32
 #define STRICT
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#endif
 #include <time.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef _WIN32
 #include <tchar.h>
 #include "XUnzip.h"
+#endif
+#include "XInflate.h"
 
 #pragma warning(disable : 4996)	// disable bogus deprecation warning
 
@@ -202,7 +209,9 @@ void zfree(void *buf)
 
 #pragma warning(disable : 4702)   // unreachable code
 
+#ifdef _WIN32
 static ZRESULT zopenerror = ZR_OK; //+++1.2
+#endif
 
 typedef struct tm_unz_s
 { unsigned int tm_sec;            // seconds after the minute - [0,59]
@@ -2660,6 +2669,37 @@ int inflate(z_streamp z, int f)
 
 
 
+int XInflateRaw(const unsigned char *src, unsigned long srcLen,
+                unsigned char *dst, unsigned long dstLen)
+{ z_stream stream;
+  stream.zalloc = (alloc_func)0;
+  stream.zfree = (free_func)0;
+  stream.opaque = (voidpf)0;
+  if (inflateInit2(&stream)!=Z_OK) return XINFLATE_MEMORY;
+
+  stream.next_in = (Byte*)src;
+  stream.avail_in = (uInt)srcLen;
+  stream.next_out = (Byte*)dst;
+  stream.avail_out = (uInt)dstLen;
+
+  int err=Z_OK;
+  while (err==Z_OK && stream.avail_in>0 && stream.avail_out>0)
+    err=inflate(&stream,Z_SYNC_FLUSH);
+  uLong total = stream.total_out;
+  inflateEnd(&stream);
+
+  // without the "dummy" byte after the stream (see unzOpenCurrentFile) a raw
+  // stream ends with Z_OK or Z_BUF_ERROR instead of Z_STREAM_END, so the size
+  // from the central dir is what tells a complete entry
+  if (err!=Z_OK && err!=Z_STREAM_END && err!=Z_BUF_ERROR) return XINFLATE_DATA;
+  if (total!=dstLen) return XINFLATE_SIZE;
+  return XINFLATE_OK;
+}
+
+
+
+#ifdef _WIN32
+
 #ifdef _UNICODE
 
 static int GetAnsiFileName(LPCWSTR name, char * buf, int nBufSize)
@@ -2865,6 +2905,17 @@ typedef struct
 } file_in_zip_read_info_s;
 
 
+// unz_index_entry is one record of the central directory, decoded once when the
+// zipfile is opened so that any entry can be reached without walking the directory
+typedef struct
+{
+	uLong pos_in_central_dir;   // pos of the record in the central dir
+	uLong pos_in_index_buffer;  // pos of the record in unz_s::index_buffer
+	unz_file_info file_info;    // method, crc, sizes, ... of the file
+	unz_file_info_internal file_info_internal; // offset of the local header
+} unz_index_entry;
+
+
 // unz_s contain internal information about the zipfile
 typedef struct
 {
@@ -2882,6 +2933,9 @@ typedef struct
 	unz_file_info cur_file_info; // public info about the current file in zip
 	unz_file_info_internal cur_file_info_internal; // private info about it
     file_in_zip_read_info_s* pfile_in_zip_read; // structure about the current file if we are decompressing it
+
+	unz_index_entry* index;     // one record per file, NULL if the index couldn't be built
+	unsigned char* index_buffer;// the central dir as read from the zipfile, referenced by index
 } unz_s, *unzFile;
 
 
@@ -3053,6 +3107,91 @@ uLong unzlocal_SearchCentralDir(LUFILE *fin)
 
 int unzGoToFirstFile (unzFile file);
 int unzCloseCurrentFile (unzFile file);
+void unzlocal_DosDateToTmuDate (uLong ulDosDate, tm_unz* ptm);
+
+
+// Decode LSB ordered values from a buffer already read from the zipfile
+uLong unzlocal_le16 (const unsigned char *p)
+{ return (uLong)p[0] | ((uLong)p[1]<<8);
+}
+
+uLong unzlocal_le32 (const unsigned char *p)
+{ return (uLong)p[0] | ((uLong)p[1]<<8) | ((uLong)p[2]<<16) | ((uLong)p[3]<<24);
+}
+
+
+// Read the whole central directory with a single read and decode every record of it.
+// On success s->index holds one unz_index_entry per file, so that going to the file
+// number i is a table lookup instead of i reads of the central directory.
+int unzlocal_BuildIndex (unz_s *s)
+{
+  s->index = NULL;
+  s->index_buffer = NULL;
+  if (s->gi.number_entry==0) return UNZ_OK;
+
+  unsigned char *buf = (unsigned char*)zmalloc(s->size_central_dir);
+  unz_index_entry *index = (unz_index_entry*)zmalloc(sizeof(unz_index_entry)*s->gi.number_entry);
+  if (buf==NULL || index==NULL)
+  { if (buf!=NULL) zfree(buf);
+    if (index!=NULL) zfree(index);
+    return UNZ_INTERNALERROR;
+  }
+
+  int err=UNZ_OK;
+  if (lufseek(s->file,s->offset_central_dir+s->byte_before_the_zipfile,SEEK_SET)!=0) err=UNZ_ERRNO;
+  else if (lufread(buf,(uInt)s->size_central_dir,1,s->file)!=1) err=UNZ_ERRNO;
+
+  uLong pos=0;
+  for (uLong i=0; i<s->gi.number_entry && err==UNZ_OK; i++)
+  { if (pos+SIZECENTRALDIRITEM>s->size_central_dir) { err=UNZ_BADZIPFILE; break; }
+    const unsigned char *p = buf+pos;
+    if (unzlocal_le32(p)!=0x02014b50) { err=UNZ_BADZIPFILE; break; }
+
+    unz_index_entry *e = &index[i];
+    e->pos_in_central_dir = s->offset_central_dir+pos;
+    e->pos_in_index_buffer = pos;
+    e->file_info.version            = unzlocal_le16(p+4);
+    e->file_info.version_needed     = unzlocal_le16(p+6);
+    e->file_info.flag               = unzlocal_le16(p+8);
+    e->file_info.compression_method = unzlocal_le16(p+10);
+    e->file_info.dosDate            = unzlocal_le32(p+12);
+    e->file_info.crc                = unzlocal_le32(p+16);
+    e->file_info.compressed_size    = unzlocal_le32(p+20);
+    e->file_info.uncompressed_size  = unzlocal_le32(p+24);
+    e->file_info.size_filename      = unzlocal_le16(p+28);
+    e->file_info.size_file_extra    = unzlocal_le16(p+30);
+    e->file_info.size_file_comment  = unzlocal_le16(p+32);
+    e->file_info.disk_num_start     = unzlocal_le16(p+34);
+    e->file_info.internal_fa        = unzlocal_le16(p+36);
+    e->file_info.external_fa        = unzlocal_le32(p+38);
+    e->file_info_internal.offset_curfile = unzlocal_le32(p+42);
+    unzlocal_DosDateToTmuDate(e->file_info.dosDate,&e->file_info.tmu_date);
+
+    pos += SIZECENTRALDIRITEM + e->file_info.size_filename +
+           e->file_info.size_file_extra + e->file_info.size_file_comment;
+    if (pos>s->size_central_dir) err=UNZ_BADZIPFILE;
+  }
+
+  if (err!=UNZ_OK)
+  { zfree(buf);
+    zfree(index);
+    return err;
+  }
+  s->index = index;
+  s->index_buffer = buf;
+  return UNZ_OK;
+}
+
+
+// Copy the name of the indexed file i into szFileName (always null terminated)
+void unzlocal_GetIndexFileName (unz_s *s, uLong i, char *szFileName, uLong fileNameBufferSize)
+{ const unz_index_entry *e = &s->index[i];
+  uLong len = e->file_info.size_filename;
+  if (len>=fileNameBufferSize) len = fileNameBufferSize-1;
+  memcpy(szFileName, s->index_buffer+e->pos_in_index_buffer+SIZECENTRALDIRITEM, len);
+  szFileName[len] = '\0';
+}
+
 
 // Open a Zip file.
 // If the zipfile cannot be opened (file don't exist or in not valid), return NULL.
@@ -3101,6 +3240,8 @@ unzFile unzOpenInternal(LUFILE *fin)
 
   unz_s *s = (unz_s*)zmalloc(sizeof(unz_s));
   *s=us;
+  // without an index every lookup falls back to walking the central dir
+  unzlocal_BuildIndex(s);
   unzGoToFirstFile((unzFile)s);
   return (unzFile)s;
 }
@@ -3122,6 +3263,8 @@ int unzClose (unzFile file)
         unzCloseCurrentFile(file);
 
 	lufclose(s->file);
+	if (s->index!=NULL) zfree(s->index);
+	if (s->index_buffer!=NULL) zfree(s->index_buffer);
 	if (s) zfree(s); // unused s=0;
 	return UNZ_OK;
 }
@@ -3371,6 +3514,38 @@ int unzGoToNextFile (unzFile file)
 }
 
 
+//  Set the current file of the zipfile to the file number index.
+//  With the central dir index this costs no read at all, otherwise the
+//  central dir is walked like unzGoToNextFile does.
+//  return UNZ_OK if there is no problem
+int unzGoToFileIndex (unzFile file, uLong index)
+{
+	unz_s* s;
+	if (file==NULL)
+		return UNZ_PARAMERROR;
+	s=(unz_s*)file;
+	if (index>=s->gi.number_entry)
+		return UNZ_PARAMERROR;
+
+	if (s->index==NULL)
+	{
+		int err=UNZ_OK;
+		if (index<s->num_file || !s->current_file_ok)
+			err=unzGoToFirstFile(file);
+		while (err==UNZ_OK && s->num_file<index)
+			err=unzGoToNextFile(file);
+		return err;
+	}
+
+	s->num_file=index;
+	s->pos_in_central_dir=s->index[index].pos_in_central_dir;
+	s->cur_file_info=s->index[index].file_info;
+	s->cur_file_info_internal=s->index[index].file_info_internal;
+	s->current_file_ok=1;
+	return UNZ_OK;
+}
+
+
 //  Try locate the file szFileName in the zipfile.
 //  For the iCaseSensitivity signification, see unzStringFileNameCompare
 //  return value :
@@ -3399,6 +3574,18 @@ int unzLocateFile (unzFile file, const TCHAR *szFileName, int iCaseSensitivity)
 #endif
 
 	s=(unz_s*)file;
+	if (s->index!=NULL)
+	{
+		for (uLong i=0; i<s->gi.number_entry; i++)
+		{
+			char szCurrentFileName[UNZ_MAXFILENAMEINZIP+1];
+			unzlocal_GetIndexFileName(s,i,szCurrentFileName,sizeof(szCurrentFileName));
+			if (unzStringFileNameCompare(szCurrentFileName,szFileNameA,iCaseSensitivity)==0)
+				return unzGoToFileIndex(file,i);
+		}
+		return UNZ_END_OF_LIST_OF_FILE;
+	}
+
 	if (!s->current_file_ok)
 		return UNZ_END_OF_LIST_OF_FILE;
 
@@ -3432,7 +3619,8 @@ int unzLocateFile (unzFile file, const TCHAR *szFileName, int iCaseSensitivity)
 int unzlocal_CheckCurrentFileCoherencyHeader (unz_s *s,uInt *piSizeVar,
   uLong *poffset_local_extrafield, uInt  *psize_local_extrafield)
 {
-	uLong uMagic,uData,uFlags;
+	unsigned char header[SIZEZIPLOCALHEADER];
+	uLong uFlags;
 	uLong size_filename;
 	uLong size_extra_field;
 	int err=UNZ_OK;
@@ -3444,60 +3632,42 @@ int unzlocal_CheckCurrentFileCoherencyHeader (unz_s *s,uInt *piSizeVar,
 	if (lufseek(s->file,s->cur_file_info_internal.offset_curfile + s->byte_before_the_zipfile,SEEK_SET)!=0)
 		return UNZ_ERRNO;
 
+	// the whole fixed part of the local header is read at once
+	if (lufread(header,SIZEZIPLOCALHEADER,1,s->file)!=1)
+		return UNZ_ERRNO;
 
-	if (err==UNZ_OK)
-		if (unzlocal_getLong(s->file,&uMagic) != UNZ_OK)
-			err=UNZ_ERRNO;
-		else if (uMagic!=0x04034b50)
-			err=UNZ_BADZIPFILE;
+	if (unzlocal_le32(header)!=0x04034b50)
+		err=UNZ_BADZIPFILE;
 
-	if (unzlocal_getShort(s->file,&uData) != UNZ_OK)
-		err=UNZ_ERRNO;
-//	else if ((err==UNZ_OK) && (uData!=s->cur_file_info.wVersion))
-//		err=UNZ_BADZIPFILE;
-	if (unzlocal_getShort(s->file,&uFlags) != UNZ_OK)
-		err=UNZ_ERRNO;
+	uFlags = unzlocal_le16(header+6);
 
-	if (unzlocal_getShort(s->file,&uData) != UNZ_OK)
-		err=UNZ_ERRNO;
-	else if ((err==UNZ_OK) && (uData!=s->cur_file_info.compression_method))
+	if ((err==UNZ_OK) && (unzlocal_le16(header+8)!=s->cur_file_info.compression_method))
 		err=UNZ_BADZIPFILE;
 
     if ((err==UNZ_OK) && (s->cur_file_info.compression_method!=0) &&
                          (s->cur_file_info.compression_method!=Z_DEFLATED))
         err=UNZ_BADZIPFILE;
 
-	if (unzlocal_getLong(s->file,&uData) != UNZ_OK) // date/time
-		err=UNZ_ERRNO;
-
-	if (unzlocal_getLong(s->file,&uData) != UNZ_OK) // crc
-		err=UNZ_ERRNO;
-	else if ((err==UNZ_OK) && (uData!=s->cur_file_info.crc) &&
-		                      ((uFlags & 8)==0))
+	// header+10 is the date/time
+	if ((err==UNZ_OK) && (unzlocal_le32(header+14)!=s->cur_file_info.crc) &&
+		                 ((uFlags & 8)==0))
 		err=UNZ_BADZIPFILE;
 
-	if (unzlocal_getLong(s->file,&uData) != UNZ_OK) // size compr
-		err=UNZ_ERRNO;
-	else if ((err==UNZ_OK) && (uData!=s->cur_file_info.compressed_size) &&
-							  ((uFlags & 8)==0))
+	if ((err==UNZ_OK) && (unzlocal_le32(header+18)!=s->cur_file_info.compressed_size) &&
+						 ((uFlags & 8)==0))
 		err=UNZ_BADZIPFILE;
 
-	if (unzlocal_getLong(s->file,&uData) != UNZ_OK) // size uncompr
-		err=UNZ_ERRNO;
-	else if ((err==UNZ_OK) && (uData!=s->cur_file_info.uncompressed_size) &&
-							  ((uFlags & 8)==0))
+	if ((err==UNZ_OK) && (unzlocal_le32(header+22)!=s->cur_file_info.uncompressed_size) &&
+						 ((uFlags & 8)==0))
 		err=UNZ_BADZIPFILE;
 
-
-	if (unzlocal_getShort(s->file,&size_filename) != UNZ_OK)
-		err=UNZ_ERRNO;
-	else if ((err==UNZ_OK) && (size_filename!=s->cur_file_info.size_filename))
+	size_filename = unzlocal_le16(header+26);
+	if ((err==UNZ_OK) && (size_filename!=s->cur_file_info.size_filename))
 		err=UNZ_BADZIPFILE;
 
 	*piSizeVar += (uInt)size_filename;
 
-	if (unzlocal_getShort(s->file,&size_extra_field) != UNZ_OK)
-		err=UNZ_ERRNO;
+	size_extra_field = unzlocal_le16(header+28);
 	*poffset_local_extrafield= s->cur_file_info_internal.offset_curfile +
 									SIZEZIPLOCALHEADER + size_filename;
 	*psize_local_extrafield = (uInt)size_extra_field;
@@ -3912,20 +4082,35 @@ ZRESULT TUnzip::Get(int index,ZIPENTRY *ze)
     ze->unc_size=0;
     return ZR_OK;
   }
-  if (index<(int)uf->num_file) unzGoToFirstFile(uf);
-  while ((int)uf->num_file<index) unzGoToNextFile(uf);
+  if (unzGoToFileIndex(uf,index)!=UNZ_OK) return ZR_CORRUPT;
   unz_file_info ufi; 
   char fn[MAX_PATH];
-  unzGetCurrentFileInfo(uf,&ufi,fn,MAX_PATH,NULL,0,NULL,0);
-
-  // now get the extra header. We do this ourselves, instead of
-  // calling unzOpenCurrentFile &c., to avoid allocating more than necessary.
-  unsigned int extralen,iSizeVar; unsigned long offset;
-  int res = unzlocal_CheckCurrentFileCoherencyHeader(uf,&iSizeVar,&offset,&extralen);
-  if (res!=UNZ_OK) return ZR_CORRUPT;
-  if (lufseek(uf->file,offset,SEEK_SET)!=0) return ZR_READ;
-  char *extra = new char[extralen];
-  if (lufread(extra,1,(uInt)extralen,uf->file)!=extralen) {delete[] extra; return ZR_READ;}
+  char *extra = NULL;
+  const char *ebuf;
+  unsigned int extralen;
+  // the central dir holds only the mtime of a "UT" field, the local header may hold all three
+  bool central = (uf->index!=NULL);
+  if (central)
+  { // everything comes from the central dir index, no need to touch the file
+    ufi = uf->cur_file_info;
+    unzlocal_GetIndexFileName(uf,index,fn,MAX_PATH);
+    ebuf = (const char*)uf->index_buffer + uf->index[index].pos_in_index_buffer +
+           SIZECENTRALDIRITEM + ufi.size_filename;
+    extralen = ufi.size_file_extra;
+  }
+  else
+  { unzGetCurrentFileInfo(uf,&ufi,fn,MAX_PATH,NULL,0,NULL,0);
+
+    // now get the extra header. We do this ourselves, instead of
+    // calling unzOpenCurrentFile &c., to avoid allocating more than necessary.
+    unsigned int iSizeVar; unsigned long offset;
+    int res = unzlocal_CheckCurrentFileCoherencyHeader(uf,&iSizeVar,&offset,&extralen);
+    if (res!=UNZ_OK) return ZR_CORRUPT;
+    if (lufseek(uf->file,offset,SEEK_SET)!=0) return ZR_READ;
+    extra = new char[extralen];
+    if (lufread(extra,1,(uInt)extralen,uf->file)!=extralen) {delete[] extra; return ZR_READ;}
+    ebuf = extra;
+  }
   //
   ze->index=uf->num_file;
   strcpy(ze->name,fn);
@@ -3960,24 +4145,24 @@ ZRESULT TUnzip::Get(int index,ZIPENTRY *ze)
   // an extra header, then we'll instead get the info from that.
   unsigned int epos=0;
   while (epos+4<extralen)
-  { char etype[3]; etype[0]=extra[epos+0]; etype[1]=extra[epos+1]; etype[2]=0;
-    int size = extra[epos+2];
+  { char etype[3]; etype[0]=ebuf[epos+0]; etype[1]=ebuf[epos+1]; etype[2]=0;
+    int size = ebuf[epos+2];
     if (strcmp(etype,"UT")!=0) {epos += 4+size; continue;}
-    int flags = extra[epos+4];
+    int flags = ebuf[epos+4];
     bool hasmtime = (flags&1)!=0;
-    bool hasatime = (flags&2)!=0;
-    bool hasctime = (flags&4)!=0;
+    bool hasatime = !central && (flags&2)!=0;
+    bool hasctime = !central && (flags&4)!=0;
     epos+=5;
     if (hasmtime)
-    { time_t mtime = *(time_t*)(extra+epos); epos+=4;
+    { time_t mtime = *(time_t*)(ebuf+epos); epos+=4;
       ze->mtime = timet2filetime(mtime);
     }
     if (hasatime)
-    { time_t atime = *(time_t*)(extra+epos); epos+=4;
+    { time_t atime = *(time_t*)(ebuf+epos); epos+=4;
       ze->atime = timet2filetime(atime);
     }
     if (hasctime)
-    { time_t ctime = *(time_t*)(extra+epos); 
+    { time_t ctime = *(time_t*)(ebuf+epos); 
       ze->ctime = timet2filetime(ctime);
     }
     break;
@@ -4053,12 +4238,10 @@ ZRESULT TUnzip::Unzip(int index,void *dst,unsigned int len,DWORD flags)
 			if (currentfile!=-1) 
 				unzCloseCurrentFile(uf); 
 			currentfile=-1;
-			if (index>=(int)uf->gi.number_entry) 
+			if (index<0 || index>=(int)uf->gi.number_entry) 
 				return ZR_ARGS;
-			if (index<(int)uf->num_file) 
-				unzGoToFirstFile(uf);
-			while ((int)uf->num_file<index) 
-				unzGoToNextFile(uf);
+			if (unzGoToFileIndex(uf,index)!=UNZ_OK) 
+				return ZR_CORRUPT;
 			unzOpenCurrentFile(uf); 
 			currentfile=index;
 		}
@@ -4077,12 +4260,10 @@ ZRESULT TUnzip::Unzip(int index,void *dst,unsigned int len,DWORD flags)
 	if (currentfile!=-1) 
 		unzCloseCurrentFile(uf); 
 	currentfile=-1;
-	if (index >= (int)uf->gi.number_entry) 
+	if (index < 0 || index >= (int)uf->gi.number_entry) 
 		return ZR_ARGS;
-	if (index < (int)uf->num_file) 
-		unzGoToFirstFile(uf);
-	while ((int)uf->num_file<index) 
-		unzGoToNextFile(uf);
+	if (unzGoToFileIndex(uf,index)!=UNZ_OK) 
+		return ZR_CORRUPT;
 	ZIPENTRY ze; 
 	Get(index,&ze);
 	ze.attr = NULL;
@@ -4181,6 +4362,9 @@ ZRESULT TUnzip::Close()
 
 
 
+// only kept for FormatZipMessage(ZR_RECENT), the functions below also return their
+// result directly. Every handle writes this one global without a lock, so
+// ZR_RECENT is only meaningful when a single thread uses the zip functions.
 ZRESULT lasterrorU=ZR_OK;
 
 unsigned int FormatZipMessageU(ZRESULT code, char *buf,unsigned int len)
@@ -4251,8 +4435,9 @@ ZRESULT GetZipItemA(HZIP hz, int index, ZIPENTRY *ze)
 		return ZR_ZMODE;
 	}
 	TUnzip *unz = han->unz;
-	lasterrorU = unz->Get(index,ze);
-	return lasterrorU;
+	ZRESULT zr = unz->Get(index,ze);
+	lasterrorU = zr;
+	return zr;
 }
 
 ZRESULT GetZipItemW(HZIP hz, int index, ZIPENTRYW *zew)
@@ -4270,8 +4455,9 @@ ZRESULT GetZipItemW(HZIP hz, int index, ZIPENTRYW *zew)
 	}
 	TUnzip *unz = han->unz;
 	ZIPENTRY ze;
-	lasterrorU = unz->Get(index,&ze);
-	if (lasterrorU == ZR_OK)
+	ZRESULT zr = unz->Get(index,&ze);
+	lasterrorU = zr;
+	if (zr == ZR_OK)
 	{
 		zew->index     = ze.index;
 		zew->attr      = ze.attr;
@@ -4286,7 +4472,7 @@ ZRESULT GetZipItemW(HZIP hz, int index, ZIPENTRYW *zew)
 		strcpy(zew->name, ze.name);
 #endif
 	}
-	return lasterrorU;
+	return zr;
 }
 
 ZRESULT FindZipItemA(HZIP hz, const TCHAR *name, bool ic, int *index, ZIPENTRY *ze)
@@ -4303,8 +4489,9 @@ ZRESULT FindZipItemA(HZIP hz, const TCHAR *name, bool ic, int *index, ZIPENTRY *
 		return ZR_ZMODE;
 	}
 	TUnzip *unz = han->unz;
-	lasterrorU = unz->Find(name,ic,index,ze);
-	return lasterrorU;
+	ZRESULT zr = unz->Find(name,ic,index,ze);
+	lasterrorU = zr;
+	return zr;
 }
 
 ZRESULT FindZipItemW(HZIP hz, const TCHAR *name, bool ic, int *index, ZIPENTRYW *zew)
@@ -4322,8 +4509,9 @@ ZRESULT FindZipItemW(HZIP hz, const TCHAR *name, bool ic, int *index, ZIPENTRYW
 	}
 	TUnzip *unz = han->unz;
 	ZIPENTRY ze;
-	lasterrorU = unz->Find(name,ic,index,&ze);
-	if (lasterrorU == ZR_OK)
+	ZRESULT zr = unz->Find(name,ic,index,&ze);
+	lasterrorU = zr;
+	if (zr == ZR_OK)
 	{
 		zew->index     = ze.index;
 		zew->attr      = ze.attr;
@@ -4339,7 +4527,7 @@ ZRESULT FindZipItemW(HZIP hz, const TCHAR *name, bool ic, int *index, ZIPENTRYW
 #endif
 	}
 
-	return lasterrorU;
+	return zr;
 }
 
 ZRESULT UnzipItem(HZIP hz, int index, void *dst, unsigned int len, DWORD flags)
@@ -4356,8 +4544,9 @@ ZRESULT UnzipItem(HZIP hz, int index, void *dst, unsigned int len, DWORD flags)
 		return ZR_ZMODE;
 	}
 	TUnzip *unz = han->unz;
-	lasterrorU = unz->Unzip(index,dst,len,flags);
-	return lasterrorU;
+	ZRESULT zr = unz->Unzip(index,dst,len,flags);
+	lasterrorU = zr;
+	return zr;
 }
 
 ZRESULT CloseZipU(HZIP hz)
@@ -4365,10 +4554,11 @@ ZRESULT CloseZipU(HZIP hz)
   TUnzipHandleData *han = (TUnzipHandleData*)hz;
   if (han->flag!=1) {lasterrorU=ZR_ZMODE;return ZR_ZMODE;}
   TUnzip *unz = han->unz;
-  lasterrorU = unz->Close();
+  ZRESULT zr = unz->Close();
+  lasterrorU = zr;
   delete unz;
   delete han;
-  return lasterrorU;
+  return zr;
 }
 
 bool IsZipHandleU(HZIP hz)
@@ -4377,4 +4567,4 @@ bool IsZipHandleU(HZIP hz)
   return (han->flag==1);
 }
 
-
+#endif // _WIN32
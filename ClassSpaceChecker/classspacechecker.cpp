@@ -2,32 +2,68 @@
 #include "classspacechecker.h"
 #include <QtGui>
 #include <qt_windows.h>
-#include "XZip/XUnZip.h"
 #include "SettingManager.hpp"
-#include "jclass/jclass.h"
 
 CSettingManager gSettingManager;
 
+// Loads the jar and counts the references of an analysis. The tables are only filled
+// by onAnalysisFinished(), on the GUI thread, once the whole run succeeded.
+class AnalysisThread : public QThread
+{
+public:
+	AnalysisThread(ClassSpaceChecker *owner) : owner_(owner)
+	{
+	}
+
+protected:
+	virtual void run()
+	{
+		owner_->runAnalysis();
+	}
+
+private:
+	ClassSpaceChecker *owner_;
+};
+
 ClassSpaceChecker::ClassSpaceChecker(QWidget *parent, Qt::WFlags flags)
 	: QMainWindow(parent, flags), prevJdProcessId_(0), initJarFileComboFlag_(false), freezeSearchClassNameFlag_(false), srcViewer_(NULL)
+	, analysisThread_(NULL), analysisResult_(false), shownStage_(STAGE_NONE)
 {
 	gSettingManager.setIniPath(qApp->applicationDirPath() + QDir::separator() + "data.ini");
 
+	// memory kept for the bytes of the last opened or searched classes
+	int entryCacheMB = gSettingManager.getValue("entryCacheMB").toInt();
+	if(entryCacheMB > 0)
+		analyzer_.setEntryCacheSize(entryCacheMB * 1024 * 1024);
+
+	// entry points of the unreachable class check besides the manifest Main-Class :
+	// ';' separated name patterns and a file of class names to keep
+	ReachabilityRoots roots;
+	roots.useMainClass = (gSettingManager.getValue("useMainClass").toString() != "false");
+	roots.namePatterns = gSettingManager.getValue("rootPatterns").toString().split(";", QString::SkipEmptyParts);
+	analyzer_.setReachabilityRoots(roots);
+	QString keepClassFile = gSettingManager.getValue("keepClassFile").toString();
+	bool keepFileLoaded = (keepClassFile.isEmpty() || analyzer_.loadKeepFile(keepClassFile));
+
 	ui.setupUi(this);
 	ui.tableWidgetResult->horizontalHeader()->setResizeMode( QHeaderView::Interactive );
 
-	ui.tableWidgetResult->setColumnCount(5);
-	ui.tableWidgetResult->setHorizontalHeaderLabels(QString("Class Name;File Size;Uncrypted Name;Method Count;Referenced Count;").split(";"));  
+	ui.tableWidgetResult->setColumnCount(9);
+	ui.tableWidgetResult->setHorizontalHeaderLabels(QString("Class Name;File Size;Uncrypted Name;Method Count;Referenced Count;Container;Parse Error;Reachable;Retained Size").split(";"));  
 	ui.tableWidgetResult->horizontalHeader()->setResizeMode( QHeaderView::Interactive );
 
-	ui.tableWidgetPackageReport->setColumnCount(6);
-	ui.tableWidgetPackageReport->setHorizontalHeaderLabels(QString("Package Name;All Class Count;Unique Count;Anonymous Count;Diff Count;File Size").split(";"));  
+	ui.tableWidgetPackageReport->setColumnCount(9);
+	ui.tableWidgetPackageReport->setHorizontalHeaderLabels(QString("Package Name;All Class Count;Unique Count;Anonymous Count;Diff Count;File Size;Unreachable Count;Unreachable Size;Retained Size").split(";"));  
 	ui.tableWidgetPackageReport->horizontalHeader()->setResizeMode( QHeaderView::Interactive );
 
 	ui.tableWidgetInnerClassReport->setColumnCount(4);
 	ui.tableWidgetInnerClassReport->setHorizontalHeaderLabels(QString("Class Name;Inner Count;Anonymous Count;File Size").split(";"));  
 	ui.tableWidgetInnerClassReport->horizontalHeader()->setResizeMode( QHeaderView::Interactive );
 
+	ui.tableWidgetDependencyReport->setColumnCount(6);
+	ui.tableWidgetDependencyReport->setHorizontalHeaderLabels(QString("Class Name;Uncrypted Name;Fan In;Fan Out;Cycle;Cycle Size").split(";"));  
+	ui.tableWidgetDependencyReport->horizontalHeader()->setResizeMode( QHeaderView::Interactive );
+
 	ui.comboBox_JarFile->lineEdit()->setPlaceholderText("Jar File (Drag&Drop supported)");
 	ui.comboBox_JarFile->installEventFilter( this );
 	ui.lineEdit_MapFile->setDragEnabled(true);
@@ -38,6 +74,12 @@ ClassSpaceChecker::ClassSpaceChecker(QWidget *parent, Qt::WFlags flags)
 
 	updateWindowTitle();
 
+	buildStatusBar();
+
+	progressTimer_ = new QTimer(this);
+	progressTimer_->setInterval(200);
+	connect(progressTimer_, SIGNAL(timeout()), this, SLOT(onAnalysisProgressTimer()));
+
 	loadPresetList(gSettingManager.getLastPresetId());
 
 	loadPreset(gSettingManager.getLastPresetId());
@@ -48,11 +90,19 @@ ClassSpaceChecker::ClassSpaceChecker(QWidget *parent, Qt::WFlags flags)
 		ui.pushButtonStart->setFocus();
 	}
 
-	buildStatusBar();
+	if(!keepFileLoaded)
+		QMessageBox::warning(this, "", tr("Keep class file not found.") + "\n" + keepClassFile);
 }
 
 ClassSpaceChecker::~ClassSpaceChecker()
 {
+	if(analysisThread_ != NULL)
+	{
+		cancelFlag_ = 1;
+		analysisThread_->wait();
+		delete analysisThread_;
+	}
+
 	if(srcViewer_ != NULL)
 		delete srcViewer_;
 }
@@ -116,6 +166,7 @@ bool ClassSpaceChecker::eventFilter(QObject *object, QEvent *evt)
 
 					if(path.indexOf(".jar", 0, Qt::CaseInsensitive) < 0 
 						&& path.indexOf(".zip", 0, Qt::CaseInsensitive) < 0
+						&& path.indexOf(".aar", 0, Qt::CaseInsensitive) < 0
 						&& path.indexOf(".txt", 0, Qt::CaseInsensitive) < 0
 						)
 						continue;
@@ -126,6 +177,7 @@ bool ClassSpaceChecker::eventFilter(QObject *object, QEvent *evt)
 						{
 							if(path.indexOf(".jar", 0, Qt::CaseInsensitive) < 0 
 								&& path.indexOf(".zip", 0, Qt::CaseInsensitive) < 0
+								&& path.indexOf(".aar", 0, Qt::CaseInsensitive) < 0
 								)
 								continue;
 						}
@@ -168,7 +220,8 @@ bool ClassSpaceChecker::eventFilter(QObject *object, QEvent *evt)
 
 					if(path.indexOf(".txt", 0, Qt::CaseInsensitive) >= 0)
 						ui.lineEdit_MapFile->setText(path);
-					if(path.indexOf(".jar", 0, Qt::CaseInsensitive) >= 0 || path.indexOf(".zip", 0, Qt::CaseInsensitive) >= 0)
+					if(path.indexOf(".jar", 0, Qt::CaseInsensitive) >= 0 || path.indexOf(".zip", 0, Qt::CaseInsensitive) >= 0
+						|| path.indexOf(".aar", 0, Qt::CaseInsensitive) >= 0)
 					{
 						checkAndJarFilePreset(path);
 					}
@@ -229,6 +282,41 @@ void ClassSpaceChecker::loadPreset(const QString &presetId)
 
 	ui.comboBox_JarFile->setEditText(preset.getKeyName());
 	ui.lineEdit_MapFile->setText(mapPath);
+
+	loadSnapshot(presetId);
+}
+
+bool ClassSpaceChecker::loadSnapshot(const QString &presetId)
+{
+	QString jarPath = ui.comboBox_JarFile->currentText();
+	QString mapPath = ui.lineEdit_MapFile->text();
+
+	if(presetId.isEmpty())
+		return false;
+
+	// already on screen
+	if(jarPath == currentJarPath_ && mapPath == currentMapPath_ && analyzer_.classes().size() > 0)
+		return true;
+
+	if(!analyzer_.loadSnapshot(gSettingManager.getSnapshotPath(presetId), jarPath, mapPath))
+		return false;
+
+	clearTables();
+
+	currentMapPath_ = mapPath;
+	currentJarPath_ = jarPath;
+
+	ui.checkBox_ByUncryptName->setEnabled(!mapPath.isEmpty());
+	ui.checkBox_ByUncryptName->setChecked(!mapPath.isEmpty());
+
+	collectData();
+
+	search();
+	analysisUniqueClassReport();
+	analysisPackageReport();
+	analysisDependencyReport();
+
+	return true;
 }
 
 void ClassSpaceChecker::saveCurrentPreset()
@@ -255,6 +343,14 @@ void ClassSpaceChecker::saveCurrentPreset()
 
 void ClassSpaceChecker::onCheckButtonClicked()
 {
+	// the button is the Cancel button while an analysis runs
+	if(analysisThread_ != NULL)
+	{
+		cancelFlag_ = 1;
+		ui.pushButtonStart->setEnabled(false);
+		return;
+	}
+
 	QString jarPath = ui.comboBox_JarFile->currentText();
 	QString mapPath = ui.lineEdit_MapFile->text();
 	QString searchText = ui.lineEdit_Search->text();
@@ -280,412 +376,199 @@ void ClassSpaceChecker::onCheckButtonClicked()
 		ui.checkBox_ByUncryptName->setChecked(false);
 	}
 	
-	if(loadJarFile(jarPath))
+	cancelFlag_ = 0;
+	analysisResult_ = false;
+	setAnalysisRunning(true);
+
+	analysisThread_ = new AnalysisThread(this);
+	connect(analysisThread_, SIGNAL(finished()), this, SLOT(onAnalysisFinished()));
+	analysisThread_->start();
+}
+
+// analysis thread
+void ClassSpaceChecker::runAnalysis()
+{
+	progressStage_ = STAGE_LOAD;
+	analysisResult_ = loadJarFile(currentJarPath_);
+	if(!analysisResult_)
+		return;
+
+	progressDone_ = 0;
+	progressTotal_ = analyzer_.classes().size();
+	progressStage_ = STAGE_COLLECT;
+	analysisResult_ = collectData();
+}
+
+void ClassSpaceChecker::onAnalysisFinished()
+{
+	analysisThread_->wait();
+	delete analysisThread_;
+	analysisThread_ = NULL;
+
+	setAnalysisRunning(false);
+
+	bool canceled = isCanceled();
+	cancelFlag_ = 0;
+
+	if(!analysisResult_ && canceled)
 	{
-		collectData();
+		ui.statusBar->showMessage(tr("Analysis canceled."), 5000);
+		return;
+	}
 
+	if(analysisResult_)
+	{
 		search();
 		analysisUniqueClassReport();
 		analysisPackageReport();
+		analysisDependencyReport();
+	}
+	else
+	{
+		QMessageBox::warning(this, "", tr("Jar file not found."));
+		ui.comboBox_JarFile->setFocus();
 	}
 
 	ui.tabWidget->setCurrentIndex(0);
 
 	saveCurrentPreset();
+
+	if(analysisResult_)
+		analyzer_.saveSnapshot(gSettingManager.getSnapshotPath(gSettingManager.getLastPresetId()));
 }
 
+void ClassSpaceChecker::setAnalysisRunning(bool running)
+{
+	// the analyzer belongs to the analysis thread until it's finished
+	ui.comboBox_JarFile->setEnabled(!running);
+	ui.pushButton_Delete->setEnabled(!running);
+	ui.toolButton_JarFile->setEnabled(!running);
+	ui.lineEdit_MapFile->setEnabled(!running);
+	ui.toolButton_MapFile->setEnabled(!running);
+	ui.lineEdit_Search->setEnabled(!running);
+	ui.pushButton_ClearSearchClass->setEnabled(!running);
+	ui.checkBox_IgnoreInnerClass->setEnabled(!running);
+	ui.checkBox_OnlyAnonymousClass->setEnabled(!running);
+	ui.checkBox_UseAsPackageName->setEnabled(!running);
+	ui.checkBox_ByUncryptName->setEnabled(!running && !currentMapPath_.isEmpty());
+	ui.lineEdit_SearchText->setEnabled(!running);
+	ui.groupBox->setEnabled(!running);
+
+	ui.pushButtonStart->setText(running ? tr("Cancel") : tr("Analysis"));
+	ui.pushButtonStart->setEnabled(true);
+
+	if(running)
+	{
+		progressStage_ = STAGE_NONE;
+		progressDone_ = 0;
+		progressTotal_ = 0;
+		shownStage_ = STAGE_NONE;
+		installStatusProgressBar(0);
+		progressTimer_->start();
+	}
+	else
+	{
+		progressTimer_->stop();
+		uninstallStatusProgressBar();
+		ui.statusBar->clearMessage();
+	}
+}
 
-void ClassSpaceChecker::removeAll() 
+void ClassSpaceChecker::onAnalysisProgressTimer()
 {
-	QList<ClassFileContext*>::iterator it = classList_.begin();
-	for(; it != classList_.end(); it++)
+	int stage = progressStage_;
+	int done = progressDone_;
+	int total = progressTotal_;
+
+	if(stage != shownStage_)
 	{
-		ClassFileContext* ctx = *it;
-		delete ctx;
+		shownStage_ = stage;
+		stageTimer_.start();
 	}
 
-	QMap<QString, PackageContext*>::iterator it2 = packageMap_.begin();
-	for(; it2 != packageMap_.end(); it2++)
+	if(progressBar_->maximum() != total)
+		progressBar_->setMaximum(total);
+	setStatusProgressValue(done);
+
+	if(isCanceled())
 	{
-		PackageContext* ctx = it2.value();
-		delete ctx;
+		ui.statusBar->showMessage(tr("Canceling..."));
+		return;
 	}
 
-	QMap<QString, UniqueClassContext*>::iterator it3 = uniqueClassMap_.begin();
-	for(; it3 != uniqueClassMap_.end(); it3++)
+	QString message = (stage == STAGE_COLLECT ? tr("Counting references") : tr("Loading classes"));
+	message += QString(" %1 / %2").arg(done).arg(total);
+
+	qint64 elapsed = stageTimer_.isValid() ? stageTimer_.elapsed() : 0;
+	if(elapsed > 0 && done > 0)
 	{
-		UniqueClassContext* ctx = it3.value();
-		delete ctx;
+		qint64 rate = (qint64)done * 1000 / elapsed;
+		message += tr(", %1 entries/s").arg(rate);
+		if(rate > 0 && total > done)
+			message += tr(", %1 s left").arg((total - done) / rate + 1);
 	}
+	ui.statusBar->showMessage(message);
+}
+
+
+void ClassSpaceChecker::removeAll() 
+{
+	// the classes stay cached, a new analysis only reads the entries that changed
+	analyzer_.clearResults();
 
-	uniqueClassMap_.clear();
-	packageMap_.clear();
-	classList_.clear();
-	proguardMap_VK_.clear();
+	clearTables();
+}
 
+void ClassSpaceChecker::clearTables() 
+{
 	ui.tableWidgetResult->clearContents();
 	ui.tableWidgetResult->setRowCount(0);
 	ui.tableWidgetPackageReport->clearContents();
 	ui.tableWidgetPackageReport->setRowCount(0);
 	ui.tableWidgetInnerClassReport->clearContents();
 	ui.tableWidgetInnerClassReport->setRowCount(0);
+	ui.tableWidgetDependencyReport->clearContents();
+	ui.tableWidgetDependencyReport->setRowCount(0);
 }
 
-bool ClassSpaceChecker::collectJavaClassInfo(const QString & classFile, ClassFileContext *ctx) 
+// analysis thread, no widget can be touched
+bool ClassSpaceChecker::loadJarFile(const QString & jarPath)
 {
-	JavaClass *clazz = jclass_class_new(toMBCS(classFile).c_str(), NULL);
-
-	if(clazz == NULL)
+	if( !analyzer_.loadJarFile(jarPath, this) ) 
 		return false;
 
-	// method count
-	ctx->methodCount = clazz->methods_count;
-	ConstantPool *constant_pool = clazz->constant_pool;
-		
-	if(constant_pool == NULL)
-		return false;
-
-	char* class_name;
-	char* method_name;
-	char* package_name;
-	char* this_class = jclass_cp_get_this_class_name(constant_pool);
-	char* this_package = jclass_get_package_from_class_name(this_class);
-
-	for(int count = 1; count < constant_pool->count; count++)
-	{
-		switch(constant_pool->entries[count].tag)
-		{
-		case CONSTANT_Class:
-			class_name = jclass_cp_get_class_name(constant_pool, count, 1);
-			package_name = jclass_get_package_from_class_name(class_name);
-
-			if(!jclass_string_is_primitive_type(class_name))
-			{
-				if(strcmp(class_name, this_class) != 0)
-				{
-					//if(strchr(class_name,'$') == NULL)
-					{
-						ctx->classReferencedList.insert(class_name);
-					}
-				}
-			}
-			free(class_name);
-
-			if(package_name != NULL)
-			{	
-				//if(do_flag & PACKAGES)
-				//	string_list_add(package_list, package_name, IS_DEPENDENCY);
-				free(package_name);
-			}
-			break;
-
-		case CONSTANT_Methodref:
-		case CONSTANT_InterfaceMethodref:
-			//if(do_flag & METHOD_REF)
-			//{
-			//	method_name = jclass_cp_get_method_signature(constant_pool, count, 1);
-			//	if(method_name != NULL)
-			//	{
-			//		class_name = jclass_get_class_from_method_signature(method_name);
-
-			//		method_flag = (strcmp(class_name, this_class)? IS_DEPENDENCY: flag);
-			//		
-			//		if (constant_pool->entries[count].tag == CONSTANT_Methodref)
-			//			string_list_add(method_list, method_name, method_flag);
-			//		else
-			//			string_list_add(interface_method_list, method_name, method_flag);
-
-			//		free(class_name);
-			//		free(method_name);
-			//	}
-
-			//}
-			break;
-		}
-	}
-	
-	free(this_class);
-	free(this_package);
-	
-	jclass_class_free(clazz);
-
 	return true;
 }
 
-
-bool ClassSpaceChecker::loadJarFile(const QString & jarPath)
+// called from the analysis thread, the progress timer picks the values up
+void ClassSpaceChecker::onProgress(int done, int total)
 {
-#if defined(Q_WS_WIN)
-	QString f = jarPath;
-	
-	HZIP hz = OpenZip( (void *)f.toStdWString().c_str(), 0, ZIP_FILENAME );
-	if( !hz ) 
-	{
-		QMessageBox::warning(this, "", tr("Jar file not found."));
-		ui.comboBox_JarFile->setFocus();
-		return false;
-	}
-
-	do{
-		ZIPENTRYW ze; 
-		ZRESULT zr = GetZipItem( hz, -1, &ze ); 
-		if( zr != ZR_OK )
-		{
-			break;
-		}
-		int numitems = ze.index;
-
-		installStatusProgressBar(numitems);
-
-		for( int i = 0; i < numitems; i++ )
-		{ 
-			GetZipItem( hz, i, &ze );
-
-			QString fileName = QString::fromStdWString(ze.name);
-
-			bool javaFileFlag = false;
-			QString ext = ".class";
-			int pos = fileName.indexOf(ext, Qt::CaseInsensitive);
-			qDebug() << "#" << ext << "> " << fileName << ":" << pos << ":" << (fileName.length() - ext.length());
-			if(pos != (fileName.length() - ext.length()))
-			{
-				ext = ".java";
-				pos = fileName.indexOf(ext, Qt::CaseInsensitive);
-				qDebug() << "#" << ext << "> " << fileName << ":" << pos << ":" << (fileName.length() - ext.length());
-				if(pos != (fileName.length() - ext.length()))
-				{
-					continue;
-				}
-				javaFileFlag = true;
-			}
-
-			ClassFileContext *ctx = new ClassFileContext();
-			
-			ctx->javaFileFlag = javaFileFlag;
-			ctx->filePath = ctx->className = fileName;
-			ctx->fileSize = ze.unc_size;
-
-			ctx->className.replace("/", ".");
-			ctx->className.remove(ext);
-
-			ctx->originalName = ctx->className;
-			
-			ctx->fullClassNameForKey = fileName;
-			ctx->fullClassNameForKey.remove(ext);
-			ctx->fullClassNameForKey.replace("/", "_");
-
-			QString output = generateFileTempPath() + ctx->fullClassNameForKey + ext;
-			zr = UnzipItem(hz, i, (void*)output.toStdWString().c_str(), 0, ZIP_FILENAME);
-			
-			ctx->referencedCount = -1;
-			ctx->methodCount = -1;
-
-			if( zr == ZR_OK ) 
-			{
-				if(javaFileFlag)
-				{
-					ctx->decompiledBuffer = readFile(output);
-				}
-				else
-				{
-					ctx->decompiledBuffer = decompileClassAndReadFile(output);
-					collectJavaClassInfo(output, ctx);
-					
-					// this infomation is set in collectData() method
-					ctx->referencedCount = 0;
-					ctx->methodCount = 0;
-				}
-
-				QFile f(output);
-				f.remove();
-			}
-
-			classList_.append(ctx);
-
-			setStatusProgressValue(i + 1);
-		}
-
-		uninstallStatusProgressBar();
-	} while( false );
-
-	CloseZip(hz);
+	progressTotal_ = total;
+	progressDone_ = done;
+}
 
-#else
-	// TODO : other platform(MacOS) unzip patch file
-	return false;
-#endif
-	return true;
+bool ClassSpaceChecker::isCanceled() const
+{
+	return cancelFlag_ != 0;
 }
 
 
 bool ClassSpaceChecker::loadMapFile(const QString & mapPath) 
 {
-	QFile file(mapPath);
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	if (!analyzer_.loadMapFile(mapPath))
 	{
 		QMessageBox::warning(this, "", tr("Proguard Map file not found."));
 		ui.lineEdit_MapFile->setFocus();
 		return false;
 	}
 
-	while (!file.atEnd()) 
-	{
-		QByteArray line = file.readLine();
-		QString lineStr(line);
-		lineStr = lineStr.trimmed();
-
-		if(lineStr.lastIndexOf(':') != lineStr.length() - 1) 
-			continue;
-
-		int pos = lineStr.indexOf("->");
-		if(pos < 0)
-			continue;
-
-		QString key;
-		QString value;
-
-		key = lineStr.left(pos).trimmed();
-		value = lineStr.mid(pos + 2).trimmed().remove(":");
-
-		proguardMap_VK_.insert(value, key);
-	}
-
 	return true;
 }
 
 
-void ClassSpaceChecker::collectData()
+bool ClassSpaceChecker::collectData()
 {
-	QList<ClassFileContext*>::iterator it = classList_.begin();
-
-	installStatusProgressBar(classList_.size());
-
-	for(int i = 0; it != classList_.end(); it++, i++)
-	{
-		ClassFileContext* ctx = *it;
-		
-		QMap<QString, QString>::iterator it = proguardMap_VK_.find(ctx->className);
-		if(it != proguardMap_VK_.end())
-		{
-			ctx->originalName = it.value();
-		}
-
-		QList<ClassFileContext*>::iterator it2 = classList_.begin();
-		for(int j = 0; it2 != classList_.end(); it2++, j++)
-		{
-			ClassFileContext* ctx2 = *it2;
-			if(ctx2->classReferencedList.find(ctx->className) != ctx2->classReferencedList.end()) 
-			{
-				ctx->referencedCount++;
-			}
-		}
-		//if(ctx->referencedCount == 0) 
-		//{
-		//	QList<ClassFileContext*>::iterator it2 = classList_.begin();
-		//	for(int j = 0; it2 != classList_.end(); it2++, j++)
-		//	{
-		//		ClassFileContext* ctx2 = *it2;
-		//		if(ctx2->decompiledBuffer.contains(ctx->className.toStdString().c_str())) 
-		//		{
-		//			ctx->referencedCount++;
-		//		}
-		//	}
-		//}
-
-		QString packageName;
-		int pos = ctx->originalName.lastIndexOf(".");
-		if(pos >= 0)
-			packageName = ctx->originalName.left(pos);
-		else
-			packageName = ctx->originalName;
-	
-		PackageContext* ctxPackage = NULL;
-		QMap<QString, PackageContext*>::iterator itPackage = packageMap_.find(packageName);
-		if(itPackage == packageMap_.end())
-		{
-			ctxPackage = new PackageContext();
-			ctxPackage->classCount = 0;
-			ctxPackage->anonymousClassCount = 0;
-			ctxPackage->fileSize = 0;
-			packageMap_.insert(packageName, ctxPackage);
-		}
-		else
-		{
-			ctxPackage = itPackage.value();
-		}
-
-		bool anonymousClassFlag = false;
-		QString uniqueClassName;
-		{
-			int pos = ctx->originalName.indexOf("$");
-			if(pos >= 0) {
-				uniqueClassName = ctx->originalName.left(pos);
-				QString right = ctx->originalName.mid(pos + 1);
-				int anonymousId = right.toUInt();
-				if(anonymousId > 0) 
-				{
-					ctxPackage->anonymousClassCount++;
-					anonymousClassFlag = true;
-				}
-			}
-			else
-				uniqueClassName = ctx->originalName;
-		}
-
-		ctxPackage->packageName = packageName;
-		ctxPackage->fileSize += ctx->fileSize;
-		ctxPackage->classCount++;
-		ctxPackage->uniqueClassNameSet.insert(uniqueClassName);
-		
-		UniqueClassContext* ctxUniqueClass = NULL;
-		QMap<QString, UniqueClassContext*>::iterator itUniqueClass = uniqueClassMap_.find(uniqueClassName);
-		if(itUniqueClass == uniqueClassMap_.end())
-		{
-			ctxUniqueClass = new UniqueClassContext();
-			ctxUniqueClass->classCount = 0;
-			ctxUniqueClass->fileSize = 0;
-			uniqueClassMap_.insert(uniqueClassName, ctxUniqueClass);
-		}
-		else
-		{
-			ctxUniqueClass = itUniqueClass.value();
-		}
-
-		ctxUniqueClass->uniqueClassName = uniqueClassName;
-		ctxUniqueClass->fileSize += ctx->fileSize;
-		ctxUniqueClass->classCount++;
-		if(anonymousClassFlag)
-			ctxUniqueClass->anonymousCount++;
-
-		setStatusProgressValue(i + 1);
-	}
-
-	uninstallStatusProgressBar();
-}
-
-QByteArray ClassSpaceChecker::decompileClassAndReadFile(const QString &classFilePath) 
-{	
-	QString uri = qApp->applicationDirPath() + "\\jad\\jad.exe";
-
-	// TODO
-	//runProgram(uri, "-o -d \"" + generateFileTempPath() + "\" \"" + classFilePath + "\"", true, true);
-
-	QString outputPath = classFilePath;
-	//outputPath = outputPath.replace(".class", ".jad");
-
-	QFile f(outputPath);
-	if(!f.open(QIODevice::ReadOnly))
-		return "";
-	return f.readAll();
-}
-
-
-QByteArray ClassSpaceChecker::readFile(const QString &filePath) 
-{	
-	QFile f(filePath);
-	if(!f.open(QIODevice::ReadOnly))
-		return "";
-	return f.readAll();
+	return analyzer_.collectData(this);
 }
 
 void ClassSpaceChecker::search()
@@ -704,9 +587,17 @@ void ClassSpaceChecker::search(const QString & searchName, const QString & searc
 							bool onlyAnonymousClass, 
 							bool useAsPackageName) 
 {
-	if(classList_.size() <= 0)
+	if(analysisThread_ != NULL || analyzer_.classes().size() <= 0)
 		return;
 
+	SearchFilter filter;
+	filter.searchName = searchName;
+	filter.searchText = searchText;
+	filter.useUncryptName = useUncryptName;
+	filter.ignoreInnerClass = ignoreInnerClass;
+	filter.onlyAnonymousClass = onlyAnonymousClass;
+	filter.useAsPackageName = useAsPackageName;
+
 	ui.tableWidgetResult->clearContents();
 	ui.tableWidgetResult->setRowCount(0);
 	ui.tableWidgetResult->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
@@ -714,80 +605,29 @@ void ClassSpaceChecker::search(const QString & searchName, const QString & searc
 	long totalSize = 0;
 	int rowCount = 0;
 	int methodCount = 0;
-	QList<ClassFileContext*>::iterator it = classList_.begin();
-	for(; it != classList_.end(); it++)
+	int unreachableCount = 0;
+	long unreachableSize = 0;
+	const ClassTable &classes = analyzer_.classes();
+	QVector<int> rows = analyzer_.search(filter);
+	QVector<int>::iterator it = rows.begin();
+	for(; it != rows.end(); it++)
 	{
 		int col = 0;
-		const ClassFileContext* ctx = *it;
-
-		int markPos = ctx->originalName.indexOf("$");
-		if(ignoreInnerClass && markPos > 0)
-			continue;
-
-		if(onlyAnonymousClass) 
-		{
-			QString right = ctx->originalName.mid(markPos + 1);
-			int anonymousId = right.toUInt();
-			if(anonymousId <= 0) 
-				continue;
-		}
-
-		if(useAsPackageName)
-		{
-			int posTemp = ctx->originalName.indexOf(searchName);
-			if(posTemp < 0)
-				continue;
-			posTemp = ctx->originalName.indexOf(".", posTemp + searchName.length() + 1);
-			if(posTemp > 0)
-				continue;
-		}
-		else 
-		{
-			if(searchName.isEmpty() == false)
-			{
-				if(useUncryptName)
-				{
-					if(ctx->originalName.contains(QRegExp(searchName, Qt::CaseInsensitive)) == false)
-						continue;
-				}
-				else
-				{
-					if(ctx->className.contains(QRegExp(searchName, Qt::CaseInsensitive)) == false)
-						continue;
-				}
-			}
-		}
-
-		if(searchText.isEmpty() == false)
-		{
-			if(ctx->javaFileFlag) 
-			{
-				QString decompiledBufferStr = ctx->decompiledBuffer;
-				if(decompiledBufferStr.contains(QRegExp(searchText, Qt::CaseSensitive)) == false)
-					continue;
-			}
-			else
-			{
-				if(ctx->decompiledBuffer.contains(searchText.toStdString().c_str()) == false)
-					continue;
-			}
-		}
-
-		QString space = QString::number(ctx->fileSize);
+		int classRow = *it;
 
 		ui.tableWidgetResult->insertRow(rowCount);
 
-		QTableWidgetItem *itemOriginal = new QTableWidgetItem(ctx->className);
+		QTableWidgetItem *itemOriginal = new QTableWidgetItem(analyzer_.className(classRow));
 		itemOriginal->setFlags(itemOriginal->flags() & ~Qt::ItemIsEditable);
-		itemOriginal->setData(Qt::UserRole, qVariantFromValue((void *)ctx));
+		itemOriginal->setData(Qt::UserRole, classRow);
 		ui.tableWidgetResult->setItem(rowCount, col++, itemOriginal);
 
 		QTableWidgetItem *itemSize = new QTableWidgetItem();
-		itemSize->setData(Qt::DisplayRole, ctx->fileSize);
+		itemSize->setData(Qt::DisplayRole, classes.fileSize(classRow));
 		itemSize->setFlags(itemSize->flags() & ~Qt::ItemIsEditable);
 		ui.tableWidgetResult->setItem(rowCount, col++, itemSize);
 
-		QString uncryptName = ctx->originalName;
+		QString uncryptName = analyzer_.originalName(classRow);
 		if(currentMapPath_.isEmpty())
 			uncryptName = "-";
 		QTableWidgetItem *itemUncrypt = new QTableWidgetItem(uncryptName);
@@ -795,19 +635,43 @@ void ClassSpaceChecker::search(const QString & searchName, const QString & searc
 		ui.tableWidgetResult->setItem(rowCount, col++, itemUncrypt);
 		
 		QTableWidgetItem *itemMethodCount = new QTableWidgetItem();
-		itemMethodCount->setData(Qt::DisplayRole, ctx->methodCount);
+		itemMethodCount->setData(Qt::DisplayRole, classes.methodCount(classRow));
 		itemMethodCount->setFlags(itemMethodCount->flags() & ~Qt::ItemIsEditable);
 		ui.tableWidgetResult->setItem(rowCount, col++, itemMethodCount);
 
 		QTableWidgetItem *itemRefCount = new QTableWidgetItem();
-		itemRefCount->setData(Qt::DisplayRole, ctx->referencedCount);
+		itemRefCount->setData(Qt::DisplayRole, classes.referencedCount(classRow));
 		itemRefCount->setFlags(itemRefCount->flags() & ~Qt::ItemIsEditable);
 		ui.tableWidgetResult->setItem(rowCount, col++, itemRefCount);
 
+		// jar stored in the analyzed jar holding the class
+		QTableWidgetItem *itemContainer = new QTableWidgetItem(analyzer_.containerPath(classRow));
+		itemContainer->setFlags(itemContainer->flags() & ~Qt::ItemIsEditable);
+		ui.tableWidgetResult->setItem(rowCount, col++, itemContainer);
+
+		QTableWidgetItem *itemError = new QTableWidgetItem(classes.parseError(classRow));
+		itemError->setFlags(itemError->flags() & ~Qt::ItemIsEditable);
+		ui.tableWidgetResult->setItem(rowCount, col++, itemError);
+
+		QTableWidgetItem *itemReachable = new QTableWidgetItem(classes.isReachable(classRow) ? "Yes" : "No");
+		itemReachable->setFlags(itemReachable->flags() & ~Qt::ItemIsEditable);
+		ui.tableWidgetResult->setItem(rowCount, col++, itemReachable);
+
+		// with the classes only reachable through this one
+		QTableWidgetItem *itemRetainedSize = new QTableWidgetItem();
+		itemRetainedSize->setData(Qt::DisplayRole, classes.retainedSize(classRow));
+		itemRetainedSize->setFlags(itemRetainedSize->flags() & ~Qt::ItemIsEditable);
+		ui.tableWidgetResult->setItem(rowCount, col++, itemRetainedSize);
+
 		rowCount++;
 
-		methodCount += ctx->methodCount;
-		totalSize += ctx->fileSize;
+		methodCount += classes.methodCount(classRow);
+		totalSize += classes.fileSize(classRow);
+		if(!classes.isReachable(classRow))
+		{
+			unreachableCount++;
+			unreachableSize += classes.fileSize(classRow);
+		}
 	}
 
 	QString resultStr;
@@ -818,6 +682,14 @@ void ClassSpaceChecker::search(const QString & searchName, const QString & searc
 	resultStr += " bytes, ";
 	resultStr += QString::number(methodCount);
 	resultStr += " methods found";
+	if(analyzer_.reachabilityRootCount() > 0)
+	{
+		resultStr += ", ";
+		resultStr += QString::number(unreachableCount);
+		resultStr += " unreachable (";
+		resultStr += numberDot(QString::number(unreachableSize));
+		resultStr += " bytes)";
+	}
 
 	ui.lineEdit_Result->setText(resultStr);
 
@@ -831,7 +703,8 @@ void ClassSpaceChecker::search(const QString & searchName, const QString & searc
 
 void ClassSpaceChecker::analysisUniqueClassReport()
 {
-	if(uniqueClassMap_.size() <= 0)
+	QList<const UniqueClassContext*> rows = analyzer_.innerClassReport();
+	if(rows.size() <= 0)
 		return;
 
 	ui.tableWidgetInnerClassReport->clearContents();
@@ -839,12 +712,10 @@ void ClassSpaceChecker::analysisUniqueClassReport()
 	ui.tableWidgetInnerClassReport->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
 
 	int rowCount = 0;
-	QMap<QString, UniqueClassContext*>::iterator it = uniqueClassMap_.begin();
-	for(; it != uniqueClassMap_.end(); it++)
+	QList<const UniqueClassContext*>::iterator it = rows.begin();
+	for(; it != rows.end(); it++)
 	{
-		const UniqueClassContext* ctx = it.value();
-		if(ctx->classCount < 2)
-			continue;
+		const UniqueClassContext* ctx = *it;
 		QString space = QString::number(ctx->fileSize);
 
 		QTableWidgetItem *itemName = new QTableWidgetItem(ctx->uniqueClassName);
@@ -878,7 +749,8 @@ void ClassSpaceChecker::analysisUniqueClassReport()
 
 void ClassSpaceChecker::analysisPackageReport() 
 {
-	if(packageMap_.size() <= 0)
+	QList<const PackageContext*> rows = analyzer_.packageReport();
+	if(rows.size() <= 0)
 		return;
 
 	ui.tableWidgetPackageReport->clearContents();
@@ -886,10 +758,10 @@ void ClassSpaceChecker::analysisPackageReport()
 	ui.tableWidgetPackageReport->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
 
 	int rowCount = 0;
-	QMap<QString, PackageContext*>::iterator it = packageMap_.begin();
-	for(; it != packageMap_.end(); it++)
+	QList<const PackageContext*>::iterator it = rows.begin();
+	for(; it != rows.end(); it++)
 	{
-		const PackageContext* ctx = it.value();
+		const PackageContext* ctx = *it;
 		QString space = QString::number(ctx->fileSize);
 
 		QTableWidgetItem *itemOriginal = new QTableWidgetItem(ctx->packageName);
@@ -916,6 +788,18 @@ void ClassSpaceChecker::analysisPackageReport()
 		itemSize->setData(Qt::DisplayRole, ctx->fileSize);
 		itemSize->setFlags(itemSize->flags() & ~Qt::ItemIsEditable);
 
+		QTableWidgetItem *itemUnreachableCount = new QTableWidgetItem();
+		itemUnreachableCount->setData(Qt::DisplayRole, ctx->unreachableClassCount);
+		itemUnreachableCount->setFlags(itemUnreachableCount->flags() & ~Qt::ItemIsEditable);
+
+		QTableWidgetItem *itemUnreachableSize = new QTableWidgetItem();
+		itemUnreachableSize->setData(Qt::DisplayRole, ctx->unreachableFileSize);
+		itemUnreachableSize->setFlags(itemUnreachableSize->flags() & ~Qt::ItemIsEditable);
+
+		QTableWidgetItem *itemRetainedSize = new QTableWidgetItem();
+		itemRetainedSize->setData(Qt::DisplayRole, ctx->retainedSize);
+		itemRetainedSize->setFlags(itemRetainedSize->flags() & ~Qt::ItemIsEditable);
+
 		ui.tableWidgetPackageReport->insertRow(rowCount);
 		ui.tableWidgetPackageReport->setItem(rowCount, 0, itemOriginal);
 		ui.tableWidgetPackageReport->setItem(rowCount, 1, itemClassCount);
@@ -923,6 +807,9 @@ void ClassSpaceChecker::analysisPackageReport()
 		ui.tableWidgetPackageReport->setItem(rowCount, 3, itemAnonymousCount);
 		ui.tableWidgetPackageReport->setItem(rowCount, 4, itemDiffCount);
 		ui.tableWidgetPackageReport->setItem(rowCount, 5, itemSize);
+		ui.tableWidgetPackageReport->setItem(rowCount, 6, itemUnreachableCount);
+		ui.tableWidgetPackageReport->setItem(rowCount, 7, itemUnreachableSize);
+		ui.tableWidgetPackageReport->setItem(rowCount, 8, itemRetainedSize);
 
 		rowCount++;
 	}
@@ -931,6 +818,61 @@ void ClassSpaceChecker::analysisPackageReport()
 }
 
 
+void ClassSpaceChecker::analysisDependencyReport()
+{
+	const DependencyGraph &graph = analyzer_.dependencyGraph();
+	if(graph.nodeCount() <= 0)
+		return;
+
+	ui.tableWidgetDependencyReport->clearContents();
+	ui.tableWidgetDependencyReport->setRowCount(0);
+	ui.tableWidgetDependencyReport->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+
+	// the members of a cycle share its number, sorting on the column groups them
+	ui.tableWidgetDependencyReport->setRowCount(graph.nodeCount());
+	for(int node = 0; node < graph.nodeCount(); node++)
+	{
+		int component = graph.component(node);
+		int cycleSize = graph.componentSize(component);
+
+		QTableWidgetItem *itemName = new QTableWidgetItem(analyzer_.className(graph.rowAt(node)));
+		itemName->setFlags(itemName->flags() & ~Qt::ItemIsEditable);
+		itemName->setData(Qt::UserRole, node);
+
+		QString uncryptName = analyzer_.originalName(graph.rowAt(node));
+		if(currentMapPath_.isEmpty())
+			uncryptName = "-";
+		QTableWidgetItem *itemUncrypt = new QTableWidgetItem(uncryptName);
+		itemUncrypt->setFlags(itemUncrypt->flags() & ~Qt::ItemIsEditable);
+
+		QTableWidgetItem *itemFanIn = new QTableWidgetItem();
+		itemFanIn->setData(Qt::DisplayRole, graph.inDegree(node));
+		itemFanIn->setFlags(itemFanIn->flags() & ~Qt::ItemIsEditable);
+
+		QTableWidgetItem *itemFanOut = new QTableWidgetItem();
+		itemFanOut->setData(Qt::DisplayRole, graph.outDegree(node));
+		itemFanOut->setFlags(itemFanOut->flags() & ~Qt::ItemIsEditable);
+
+		QTableWidgetItem *itemCycle = new QTableWidgetItem();
+		itemCycle->setData(Qt::DisplayRole, cycleSize > 1 ? component + 1 : 0);
+		itemCycle->setFlags(itemCycle->flags() & ~Qt::ItemIsEditable);
+
+		QTableWidgetItem *itemCycleSize = new QTableWidgetItem();
+		itemCycleSize->setData(Qt::DisplayRole, cycleSize > 1 ? cycleSize : 0);
+		itemCycleSize->setFlags(itemCycleSize->flags() & ~Qt::ItemIsEditable);
+
+		ui.tableWidgetDependencyReport->setItem(node, 0, itemName);
+		ui.tableWidgetDependencyReport->setItem(node, 1, itemUncrypt);
+		ui.tableWidgetDependencyReport->setItem(node, 2, itemFanIn);
+		ui.tableWidgetDependencyReport->setItem(node, 3, itemFanOut);
+		ui.tableWidgetDependencyReport->setItem(node, 4, itemCycle);
+		ui.tableWidgetDependencyReport->setItem(node, 5, itemCycleSize);
+	}
+
+	ui.tableWidgetDependencyReport->horizontalHeader()->resizeSections(QHeaderView::ResizeToContents);
+}
+
+
 void ClassSpaceChecker::writeToCSVFile(const QTableWidget *tableWidget, const QString & outputPath)
 {
 	QFile outputFile(outputPath);
@@ -999,7 +941,7 @@ void ClassSpaceChecker::onChangedSearchText(QString text)
 
 void ClassSpaceChecker::onClickedJarFile()
 {
-	QString fileName = QFileDialog::getOpenFileName(this, tr("Jar File"), ui.comboBox_JarFile->currentText(), tr("Jar Files (*.jar *.zip)"));
+	QString fileName = QFileDialog::getOpenFileName(this, tr("Jar File"), ui.comboBox_JarFile->currentText(), tr("Jar Files (*.jar *.zip *.aar)"));
  
 	if(fileName.isEmpty() == false)
 	{
@@ -1032,8 +974,10 @@ void ClassSpaceChecker::onClickedExportCSV()
 		table = ui.tableWidgetResult;
 	else if(idx == 1)
 		table = ui.tableWidgetPackageReport;
-	else
+	else if(idx == 2)
 		table = ui.tableWidgetInnerClassReport;
+	else
+		table = ui.tableWidgetDependencyReport;
 
 	writeToCSVFile(table, fileName);
 }
@@ -1101,6 +1045,7 @@ void ClassSpaceChecker::onPackageReportItemSelectionChanged()
 	int uniqueClassCount = 0;
 	int diffClassCount = 0;
 	int totalSize = 0;
+	int unreachableSize = 0;
 	for(int i = 0; i < items.size(); i++) 
 	{
 		QTableWidgetItem *item = items.at(i);
@@ -1127,6 +1072,7 @@ void ClassSpaceChecker::onPackageReportItemSelectionChanged()
 		if(itemFileSize == NULL)
 			continue;
 		totalSize += itemFileSize->data(Qt::DisplayRole).toInt();
+		unreachableSize += getIntFromTableItem(ui.tableWidgetPackageReport, item->row(), 7);
 		set.insert(row);
 	}
 
@@ -1141,6 +1087,12 @@ void ClassSpaceChecker::onPackageReportItemSelectionChanged()
 	resultStr += ", File Size : ";
 	resultStr += numberDot(QString::number(totalSize));
 	resultStr += " bytes";
+	if(analyzer_.reachabilityRootCount() > 0)
+	{
+		resultStr += ", Unreachable Size : ";
+		resultStr += numberDot(QString::number(unreachableSize));
+		resultStr += " bytes";
+	}
 
 	ui.lineEdit_Result->setText(resultStr);
 }
@@ -1197,6 +1149,45 @@ void ClassSpaceChecker::onInnerClassReportItemSelectionChanged()
 	ui.lineEdit_Result->setText(resultStr);
 }
 
+// the transitive dependencies of the selected classes, and the classes depending on them
+void ClassSpaceChecker::onDependencyReportItemSelectionChanged()
+{
+	QList<QTableWidgetItem *> items = ui.tableWidgetDependencyReport->selectedItems();
+	if(items.size() <= 0)
+	{
+		ui.lineEdit_Result->setText(prevTotalResultStr_);
+		return;
+	}
+
+	QSet<int> set;
+	QVector<int> nodes;
+	for(int i = 0; i < items.size(); i++) 
+	{
+		QTableWidgetItem *item = items.at(i);
+		int row = item->row();
+		if(set.find(row) != set.end())
+			continue;
+		set.insert(row);
+
+		QTableWidgetItem *itemName = ui.tableWidgetDependencyReport->item(row, 0);
+		if(itemName == NULL)
+			continue;
+		nodes.append(itemName->data(Qt::UserRole).toInt());
+	}
+
+	const DependencyGraph &graph = analyzer_.dependencyGraph();
+	QString resultStr;
+	resultStr += "Selected Count : ";
+	resultStr += QString::number(set.size());
+	resultStr += ", Depends On : ";
+	resultStr += QString::number(graph.dependencies(nodes).size());
+	resultStr += " classes, Used By : ";
+	resultStr += QString::number(graph.dependents(nodes).size());
+	resultStr += " classes";
+
+	ui.lineEdit_Result->setText(resultStr);
+}
+
 void ClassSpaceChecker::onPackageReportCellDoubleClicked(int row, int column)
 {
 	QTableWidgetItem *item = ui.tableWidgetPackageReport->item(row, 0);
@@ -1220,17 +1211,17 @@ void ClassSpaceChecker::onResultCellDoubleClicked(int row, int column)
 	if(item == NULL)
 		return;
 
-	const ClassFileContext *ctx = reinterpret_cast<ClassFileContext *>(item->data(Qt::UserRole).value<void *>());
-	if(ctx == NULL)
+	QVariant classRow = item->data(Qt::UserRole);
+	if(!classRow.isValid() || classRow.toInt() >= analyzer_.classes().size())
 		return;
 
-	if(ctx->javaFileFlag)
+	if(analyzer_.classes().javaFileFlag(classRow.toInt()))
 	{
-		openJavaFile(currentJarPath_, ctx);
+		openJavaFile(classRow.toInt());
 	}
 	else
 	{
-		openClassFile(currentJarPath_, ctx);
+		openClassFile(classRow.toInt());
 	}
 }
 
@@ -1271,16 +1262,13 @@ unsigned long ClassSpaceChecker::runProgram(const QString &theUri, const QString
 }
 
 
-QString ClassSpaceChecker::unzipFile(const QString &jarPath, const ClassFileContext *ctx)
+QString ClassSpaceChecker::unzipFile(int classRow)
 {
 	QString output;
 	bool ok = false;
 
-#if defined(Q_WS_WIN)
-	QString f = jarPath;
-	
-	HZIP hz = OpenZip( (void *)f.toStdWString().c_str(), 0, ZIP_FILENAME );
-	if( !hz ) 
+	const JarReader &jarReader = analyzer_.jarReader();
+	if( !jarReader.isOpen() || analyzer_.classes().zipIndex(classRow) < 0 ) 
 	{
 		QMessageBox::warning(this, "", tr("Jar file not found."));
 		ui.comboBox_JarFile->setFocus();
@@ -1288,41 +1276,30 @@ QString ClassSpaceChecker::unzipFile(const QString &jarPath, const ClassFileCont
 	}
 
 	do{
-		ZIPENTRYW ze; 
-		ZRESULT zr = GetZipItem( hz, -1, &ze ); 
-		if( zr != ZR_OK )
-			break;
-		
-		int i; 
-		zr = FindZipItem(hz, ctx->filePath.toStdWString().c_str(), true, &i, &ze);
-		if( zr != ZR_OK )
+		QByteArray buffer = analyzer_.entryBytes(classRow);
+		if( buffer.isEmpty() && analyzer_.classes().fileSize(classRow) > 0 )
 			break;
 
 		//QString output = generateFileTempPath() + "Temp.class";
-		output = generateFileTempPath() + ctx->fullClassNameForKey + (ctx->javaFileFlag ? ".java" : ".class");
-		zr = UnzipItem(hz, i, (void*)output.toStdWString().c_str(), 0, ZIP_FILENAME);
-		if( zr != ZR_OK )
+		output = generateFileTempPath() + analyzer_.fullClassNameForKey(classRow) + (analyzer_.classes().javaFileFlag(classRow) ? ".java" : ".class");
+		QFile file(output);
+		if( !file.open(QIODevice::WriteOnly | QIODevice::Truncate) )
+			break;
+		if( file.write(buffer) != buffer.size() )
 			break;
 
 		ok = true;
 	} while( false );
 
-	CloseZip(hz);
-
-#else
-	// TODO : other platform(MacOS) unzip patch file
-	return false;
-#endif
-
 	if(ok)
 		return output;
 
 	return "";
 }
 
-void ClassSpaceChecker::openJavaFile(const QString &jarPath, const ClassFileContext *ctx)
+void ClassSpaceChecker::openJavaFile(int classRow)
 {
-	QString output = unzipFile(jarPath, ctx);
+	QString output = unzipFile(classRow);
 	if(output.isEmpty())
 	{
 		QMessageBox::warning(this, "", tr("Can not open this java file."));
@@ -1341,7 +1318,7 @@ void ClassSpaceChecker::openJavaFile(const QString &jarPath, const ClassFileCont
 
 	if(srcViewer_ == NULL)
 		srcViewer_ = new SourceViewer(this);
-	srcViewer_->setSourceText(ctx->fullClassNameForKey, getFileName(ctx->filePath), ui.lineEdit_SearchText->text(), ctx->decompiledBuffer);
+	srcViewer_->setSourceText(analyzer_.fullClassNameForKey(classRow), getFileName(analyzer_.filePath(classRow)), ui.lineEdit_SearchText->text(), analyzer_.entryBytes(classRow));
 	srcViewer_->show();
 
 	//QString uri = "wordpad";
@@ -1354,9 +1331,9 @@ void ClassSpaceChecker::openJavaFile(const QString &jarPath, const ClassFileCont
 }
 
 
-void ClassSpaceChecker::openClassFile(const QString &jarPath, const ClassFileContext *ctx)
+void ClassSpaceChecker::openClassFile(int classRow)
 {
-	QString output = unzipFile(jarPath, ctx);
+	QString output = unzipFile(classRow);
 	if(output.isEmpty())
 	{
 		QMessageBox::warning(this, "", tr("Can not open this class file."));
@@ -1409,6 +1386,7 @@ void ClassSpaceChecker::onClickedDelete()
 	QString presetId = ui.comboBox_JarFile->itemData( ui.comboBox_JarFile->currentIndex() ).toString();
 
 	gSettingManager.removeValue(presetId);
+	QFile::remove(gSettingManager.getSnapshotPath(presetId));
 
 	ui.comboBox_JarFile->removeItem(ui.comboBox_JarFile->currentIndex());
 
@@ -5,6 +5,7 @@
 #include <QtGui>
 #include "ui_classspacechecker.h"
 #include <atlbase.h>
+#include "JarAnalyzer.h"
 #include "sourceviewer.h"
 
 #define VERSION_TEXT	"1.2.5"
@@ -12,48 +13,9 @@
 #define AUTHOR_TEXT		"gunoodaddy"
 #define PROGRAM_TEXT	"Java Class Analysis"
 
+class AnalysisThread;
 
-class ClassFileContext 
-{
-public:
-	ClassFileContext() : fileSize(0), methodCount(0), referencedCount(0)
-	{
-	}
-
-	QString className;
-	QString filePath;
-	QString originalName;
-	QString fullClassNameForKey;
-	long fileSize;
-	int methodCount;
-	int referencedCount;
-	bool javaFileFlag;
-	QByteArray decompiledBuffer;
-	QSet<QString> classReferencedList;
-};
-
-class UniqueClassContext 
-{
-public:
-	int classCount;
-	int anonymousCount;
-	long fileSize;
-	QString uniqueClassName;
-};
-
-class PackageContext 
-{
-public:
-	int classCount;
-	int uniqueClassCount;
-	int anonymousClassCount;
-	long fileSize;
-	QSet<QString> uniqueClassNameSet;
-	QString packageName;
-};
-
-
-class ClassSpaceChecker : public QMainWindow
+class ClassSpaceChecker : public QMainWindow, public ProgressListener
 {
 	Q_OBJECT
 
@@ -77,37 +39,50 @@ public slots:
 	void onPackageReportCellDoubleClicked(int row, int column);
 	void onPackageReportItemSelectionChanged();
 	void onInnerClassReportItemSelectionChanged();
+	void onDependencyReportItemSelectionChanged();
 	void onTabCurrentChanged(int index);
 	void onJarFileEditTextChanged(QString text);
 	void onClickedDelete();
 	void onClickedClearSearchClass();
 	void onClickedUseAsPackageName();
+	void onAnalysisFinished();
+	void onAnalysisProgressTimer();
 	bool eventFilter(QObject *object, QEvent *evt);
 
 private:
+	friend class AnalysisThread;
+
+	// what the analysis thread is doing, shown by the progress timer
+	enum { STAGE_NONE = 0, STAGE_LOAD, STAGE_COLLECT };
+
 	int getIntFromTableItem(QTableWidget *table, int row, int column, int def = 0); 
 	void buildStatusBar();
 	void installStatusProgressBar(int maxValue);
 	void uninstallStatusProgressBar();
 	void setStatusProgressValue(int pos);
-	bool collectJavaClassInfo(const QString & classFile, ClassFileContext *ctx);
-	QByteArray decompileClassAndReadFile(const QString &classFilePath);
-	QByteArray readFile(const QString &filePath);
+	virtual void onProgress(int done, int total);
+	virtual bool isCanceled() const;
+	void runAnalysis();
+	void setAnalysisRunning(bool running);
 	void checkAndJarFilePreset(const QString &jarPath);
 	void saveCurrentPreset();
 	void loadPreset(const QString &jarPath);
+	bool loadSnapshot(const QString &presetId);
 	void loadPresetList(const QString &selectPresetId);
 	bool loadJarFile(const QString & jarPath);
 	bool loadMapFile(const QString & mapPath);
-	void collectData();
+	bool collectData();
 	void search();
 	void search(const QString & searchName, const QString & searchText, bool useUncryptName, bool ignoreInnerClass, bool onlyAnonymousClass, bool useAsPackageName);
 	void analysisPackageReport();
 	void analysisUniqueClassReport();
+	void analysisDependencyReport();
 	void removeAll();
-	QString unzipFile(const QString &jarPath, const ClassFileContext *ctx);
-	void openJavaFile(const QString &jarPath, const ClassFileContext *ctx);
-	void openClassFile(const QString &jarPath, const ClassFileContext *ctx);
+	void clearTables();
+	// row of JarAnalyzer::classes()
+	QString unzipFile(int classRow);
+	void openJavaFile(int classRow);
+	void openClassFile(int classRow);
 	void writeToCSVFile(const QTableWidget *tableWidget, const QString & outputPath);
 	unsigned long runProgram(const QString &theUri, const QString &param, bool silentMode = false, bool waitExit = false);
 
@@ -172,14 +147,20 @@ private:
 private:
 	QString currentJarPath_;
 	QString currentMapPath_;
-	QList<ClassFileContext*> classList_;
-	QMap<QString, UniqueClassContext*> uniqueClassMap_;
-	QMap<QString, PackageContext*> packageMap_;
-	QMap<QString, QString> proguardMap_VK_;
+	JarAnalyzer analyzer_;
 	QString prevTotalResultStr_;
 	unsigned long prevJdProcessId_;
 	bool initJarFileComboFlag_;
 	QProgressBar *progressBar_;
+	AnalysisThread *analysisThread_;
+	bool analysisResult_;
+	QAtomicInt cancelFlag_;
+	QAtomicInt progressStage_;
+	QAtomicInt progressDone_;
+	QAtomicInt progressTotal_;
+	QTimer *progressTimer_;
+	int shownStage_;
+	QElapsedTimer stageTimer_;
 	SourceViewer *srcViewer_;
 	bool freezeSearchClassNameFlag_;
 };
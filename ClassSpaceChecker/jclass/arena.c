@@ -0,0 +1,159 @@
+/* libjclass - Library for reading java class files
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+
+#include <jclass/arena.h>
+
+/* Every allocation is rounded up to this, enough for any field of the parse results */
+#define ARENA_ALIGN 8
+#define ARENA_ROUND(size) (((size) + ARENA_ALIGN - 1) & ~((size_t) ARENA_ALIGN - 1))
+
+struct JClassArenaBlock {
+	JClassArenaBlock *next;
+	size_t size;
+	size_t used;
+	/* Keeps the data that follows aligned */
+	double align;
+};
+
+static JClassArenaBlock* new_block(JClassArena* arena, size_t size)
+{
+	JClassArenaBlock* block;
+	
+	block = (JClassArenaBlock*) malloc(sizeof(JClassArenaBlock) + size);
+	if(block == NULL)
+		return NULL;
+	
+	block->size = size;
+	block->used = 0;
+	block->next = arena->blocks;
+	arena->blocks = block;
+	arena->block_count++;
+	
+	return block;
+}
+
+/**
+* jclass_arena_new
+* @block_size: The size of the blocks the arena gets from malloc.
+*
+* Creates an empty arena. No block is allocated until the first
+* jclass_arena_alloc().
+*
+* Returns: A JClassArena struct, free it with jclass_arena_free(),
+* NULL if malloc failed.
+*/
+JClassArena* jclass_arena_new(size_t block_size)
+{
+	JClassArena* arena;
+	
+	arena = (JClassArena*) malloc(sizeof(JClassArena));
+	if(arena == NULL)
+		return NULL;
+	
+	arena->blocks = NULL;
+	arena->block_size = ARENA_ROUND(block_size);
+	arena->block_count = 0;
+	
+	return arena;
+}
+
+/**
+* jclass_arena_alloc
+* @arena: The arena to allocate from.
+* @size: The number of bytes needed.
+*
+* Allocates from the current block of the arena. When it is full a new
+* block is taken, a request bigger than a block gets a block of its own.
+*
+* Returns: The allocated memory, NULL if malloc failed.
+*/
+void* jclass_arena_alloc(JClassArena* arena, size_t size)
+{
+	JClassArenaBlock* block = arena->blocks;
+	void* ptr;
+	
+	size = ARENA_ROUND(size);
+	
+	if(block == NULL || block->size - block->used < size)
+	{
+		block = new_block(arena, size > arena->block_size ? size : arena->block_size);
+		if(block == NULL)
+			return NULL;
+	}
+	
+	ptr = (char*) (block + 1) + block->used;
+	block->used += size;
+	
+	return ptr;
+}
+
+/**
+* jclass_arena_reset
+* @arena: The arena to reset.
+*
+* Releases everything allocated from the arena. The last block is kept
+* for the next allocations, the others are freed: an arena that fits in
+* one block is reset without calling free().
+*/
+void jclass_arena_reset(JClassArena* arena)
+{
+	JClassArenaBlock* block;
+	JClassArenaBlock* next;
+	
+	if(arena->blocks == NULL)
+		return;
+	
+	block = arena->blocks->next;
+	while(block != NULL)
+	{
+		next = block->next;
+		free(block);
+		block = next;
+	}
+	
+	arena->blocks->next = NULL;
+	arena->blocks->used = 0;
+}
+
+/**
+* jclass_arena_free
+* @arena: The arena to free.
+*
+* Frees the arena with everything allocated from it.
+*/
+void jclass_arena_free(JClassArena* arena)
+{
+	JClassArenaBlock* block;
+	JClassArenaBlock* next;
+	
+	block = arena->blocks;
+	while(block != NULL)
+	{
+		next = block->next;
+		free(block);
+		block = next;
+	}
+	
+	free(arena);
+}
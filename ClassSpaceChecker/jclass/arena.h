@@ -0,0 +1,50 @@
+/* libjclass - Library for reading java class files
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307 USA
+ */
+
+#ifndef __JCLASS_ARENA_H__
+#define __JCLASS_ARENA_H__
+
+#ifdef _cplusplus
+  extern "C" {
+#endif 
+
+#include <stdlib.h>
+
+typedef struct JClassArenaBlock JClassArenaBlock;
+
+/* Bump allocator. Everything allocated from it is released at once by
+ * jclass_arena_reset() or jclass_arena_free(), never one by one.
+ * An arena must only be used by one thread at a time.
+ */
+typedef struct JClassArena {
+	JClassArenaBlock *blocks;
+	size_t block_size;
+	/* Number of blocks malloc'ed since the arena was created */
+	unsigned long block_count;
+} JClassArena;
+
+JClassArena* jclass_arena_new(size_t block_size);
+void* jclass_arena_alloc(JClassArena *arena, size_t size);
+void jclass_arena_reset(JClassArena *arena);
+void jclass_arena_free(JClassArena *arena);
+
+#ifdef _cplusplus
+ }
+#endif 
+
+#endif /* __JCLASS_ARENA_H__ */
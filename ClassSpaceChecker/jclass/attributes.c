@@ -214,3 +214,263 @@ void jclass_innerclasses_attribute_free(InnerClassesAttribute* attribute)
 		free(attribute->classes);
 	free(attribute);
 }
+
+/**
+* jclass_bootstrapmethods_attribute_new
+* @container: The attribute container.
+*
+* Extracts a BootstrapMethods attribute from its attribute container.
+* It holds the bootstrap methods of the CONSTANT_InvokeDynamic and
+* CONSTANT_Dynamic entries of the class.
+*
+* Returns: A newly constructed BootstrapMethodsAttribute.
+*/
+BootstrapMethodsAttribute* jclass_bootstrapmethods_attribute_new(const AttributeContainer* container)
+{
+	BootstrapMethodsAttribute* attrib;
+	BootstrapMethodInfo* method;
+	uint32_t offset;
+	uint16_t i;
+	uint16_t j;
+	uint16_t temp;
+	
+	attrib = (BootstrapMethodsAttribute*) malloc(sizeof(BootstrapMethodsAttribute));
+	
+	memcpy(&temp, &(container->contents[0]), 2);
+	attrib->no_bootstrap_methods = UINT16_NATIVE(temp);
+	
+	if(attrib->no_bootstrap_methods)
+		attrib->methods = (BootstrapMethodInfo*) malloc(attrib->no_bootstrap_methods * sizeof(BootstrapMethodInfo));
+	else
+		attrib->methods = NULL;
+	
+	offset = 2;
+	for(i = 0; i < attrib->no_bootstrap_methods; i++)
+	{
+		method = &attrib->methods[i];
+		
+		memcpy(&temp, &(container->contents[offset]), 2);
+		method->method_ref = UINT16_NATIVE(temp);
+		memcpy(&temp, &(container->contents[offset + 2]), 2);
+		method->no_arguments = UINT16_NATIVE(temp);
+		offset += 4;
+		
+		if(method->no_arguments)
+			method->arguments = (uint16_t*) malloc(method->no_arguments * sizeof(uint16_t));
+		else
+			method->arguments = NULL;
+		
+		for(j = 0; j < method->no_arguments; j++)
+		{
+			memcpy(&temp, &(container->contents[offset]), 2);
+			method->arguments[j] = UINT16_NATIVE(temp);
+			offset += 2;
+		}
+	}
+	
+	return attrib;
+}
+
+/**
+* jclass_bootstrapmethods_attribute_free
+* @attribute: The BootstrapMethods attribute to free.
+*
+* Frees a BootstrapMethods attribute.
+*/
+void jclass_bootstrapmethods_attribute_free(BootstrapMethodsAttribute* attribute)
+{
+	uint16_t i;
+	
+	if(attribute->methods != NULL)
+	{
+		for(i = 0; i < attribute->no_bootstrap_methods; i++)
+		{
+			if(attribute->methods[i].arguments != NULL)
+				free(attribute->methods[i].arguments);
+		}
+		free(attribute->methods);
+	}
+	free(attribute);
+}
+
+/**
+* jclass_nesthost_attribute_new
+* @container: The attribute container.
+*
+* Extracts a NestHost attribute from its attribute container.
+*
+* Returns: A newly constructed NestHostAttribute.
+*/
+NestHostAttribute* jclass_nesthost_attribute_new(const AttributeContainer* container)
+{
+	NestHostAttribute* attribute;
+	attribute = (NestHostAttribute*) malloc(sizeof(NestHostAttribute));
+	
+	memcpy(&attribute->host_class_index, &(container->contents[0]), 2);
+	attribute->host_class_index = UINT16_NATIVE(attribute->host_class_index);
+	
+	return attribute;
+}
+
+/**
+* jclass_nesthost_attribute_free
+* @attribute: The NestHost attribute to free.
+*
+* Frees a NestHost attribute.
+*/
+void jclass_nesthost_attribute_free(NestHostAttribute* attribute)
+{
+	free(attribute);
+}
+
+/**
+* jclass_nestmembers_attribute_new
+* @container: The attribute container.
+*
+* Extracts a NestMembers attribute from its attribute container.
+* A PermittedSubclasses attribute has the same layout and is
+* extracted the same way.
+*
+* Returns: A newly constructed NestMembersAttribute.
+*/
+NestMembersAttribute* jclass_nestmembers_attribute_new(const AttributeContainer* container)
+{
+	NestMembersAttribute* attribute;
+	uint16_t j;
+	
+	attribute = (NestMembersAttribute*) malloc(sizeof(NestMembersAttribute));
+	
+	memcpy(&attribute->no_classes, &(container->contents[0]), 2);
+	attribute->no_classes = UINT16_NATIVE(attribute->no_classes);
+	
+	if(attribute->no_classes)
+		attribute->classes = (uint16_t*) malloc(sizeof(uint16_t) * attribute->no_classes);
+	else
+		attribute->classes = NULL;
+
+	for(j = 0; j < attribute->no_classes; j++)
+	{
+		memcpy(&attribute->classes[j], &(container->contents[(j*2) + 2]), 2);
+		attribute->classes[j] = UINT16_NATIVE(attribute->classes[j]);
+	}
+	
+	return attribute;
+}
+
+/**
+* jclass_nestmembers_attribute_free
+* @attribute: The NestMembers attribute to free.
+*
+* Frees a NestMembers attribute.
+*/
+void jclass_nestmembers_attribute_free(NestMembersAttribute* attribute)
+{
+	if(attribute->classes != NULL)
+		free(attribute->classes);
+	
+	free(attribute);
+}
+
+/**
+* jclass_record_attribute_new
+* @container: The attribute container.
+*
+* Extracts a Record attribute from its attribute container.
+* The attributes of the components are copied.
+*
+* Returns: A newly constructed RecordAttribute.
+*/
+RecordAttribute* jclass_record_attribute_new(const AttributeContainer* container)
+{
+	RecordAttribute* attrib;
+	RecordComponentInfo* component;
+	AttributeContainer* component_attribute;
+	uint32_t offset;
+	uint16_t i;
+	uint16_t j;
+	uint16_t temp;
+	
+	attrib = (RecordAttribute*) malloc(sizeof(RecordAttribute));
+	
+	memcpy(&temp, &(container->contents[0]), 2);
+	attrib->no_components = UINT16_NATIVE(temp);
+	
+	if(attrib->no_components)
+		attrib->components = (RecordComponentInfo*) malloc(attrib->no_components * sizeof(RecordComponentInfo));
+	else
+		attrib->components = NULL;
+	
+	offset = 2;
+	for(i = 0; i < attrib->no_components; i++)
+	{
+		component = &attrib->components[i];
+		
+		memcpy(&temp, &(container->contents[offset]), 2);
+		component->name_index = UINT16_NATIVE(temp);
+		memcpy(&temp, &(container->contents[offset + 2]), 2);
+		component->descriptor_index = UINT16_NATIVE(temp);
+		memcpy(&temp, &(container->contents[offset + 4]), 2);
+		component->attributes_count = UINT16_NATIVE(temp);
+		offset += 6;
+		
+		if(component->attributes_count)
+			component->attributes = (AttributeContainer*) malloc(component->attributes_count * sizeof(AttributeContainer));
+		else
+			component->attributes = NULL;
+		
+		for(j = 0; j < component->attributes_count; j++)
+		{
+			component_attribute = &component->attributes[j];
+			
+			memcpy(&component_attribute->name_index, &(container->contents[offset]), 2);
+			component_attribute->name_index = UINT16_NATIVE(component_attribute->name_index);
+			memcpy(&component_attribute->length, &(container->contents[offset + 2]), 4);
+			component_attribute->length = UINT32_NATIVE(component_attribute->length);
+			offset += 6;
+			
+			if(component_attribute->length > 0)
+			{
+				component_attribute->contents = (uint8_t*) malloc(component_attribute->length);
+				memcpy(component_attribute->contents, &(container->contents[offset]), component_attribute->length);
+			}
+			else
+				component_attribute->contents = NULL;
+			
+			offset += component_attribute->length;
+		}
+	}
+	
+	return attrib;
+}
+
+/**
+* jclass_record_attribute_free
+* @attribute: The Record attribute to free.
+*
+* Frees a Record attribute.
+*/
+void jclass_record_attribute_free(RecordAttribute* attribute)
+{
+	RecordComponentInfo* component;
+	uint16_t i;
+	uint16_t j;
+	
+	if(attribute->components != NULL)
+	{
+		for(i = 0; i < attribute->no_components; i++)
+		{
+			component = &attribute->components[i];
+			if(component->attributes == NULL)
+				continue;
+			
+			for(j = 0; j < component->attributes_count; j++)
+			{
+				if(component->attributes[j].contents != NULL)
+					free(component->attributes[j].contents);
+			}
+			free(component->attributes);
+		}
+		free(attribute->components);
+	}
+	free(attribute);
+}
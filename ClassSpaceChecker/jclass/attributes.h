@@ -72,6 +72,53 @@ typedef struct {
 	uint16_t cp_index;
 } ConstantValueAttribute;
 
+typedef struct {
+	/* The index in the constant pool of the MethodHandleEntry
+	* of the bootstrap method.
+	*/
+	uint16_t method_ref;
+	uint16_t no_arguments;
+	/* Indexes in the constant pool of the static arguments */
+	uint16_t* arguments;
+} BootstrapMethodInfo;
+
+typedef struct {
+	uint16_t no_bootstrap_methods;
+	BootstrapMethodInfo* methods;
+} BootstrapMethodsAttribute;
+
+typedef struct {
+	/* Index to the constant pool for the ClassEntry
+	of the host of the nest.
+	*/
+	uint16_t host_class_index;
+} NestHostAttribute;
+
+/* Also holds a PermittedSubclasses attribute, they share the layout */
+typedef struct {
+	uint16_t no_classes;
+	/* Indexes in the constant pool of ClassEntries */
+	uint16_t* classes;
+} NestMembersAttribute;
+
+typedef struct {
+	/* The index in the constant pool of the UTF8Entry 
+	* with the name of the component.
+	*/
+	uint16_t name_index;
+	/* The index in the constant pool of the UTF8Entry 
+	* with the field descriptor of the component.
+	*/
+	uint16_t descriptor_index;
+	uint16_t attributes_count;
+	AttributeContainer* attributes;
+} RecordComponentInfo;
+
+typedef struct {
+	uint16_t no_components;
+	RecordComponentInfo* components;
+} RecordAttribute;
+
 typedef struct {
 	/* The start PC of the exception handler scope. */
 	uint16_t start_pc;
@@ -155,6 +202,18 @@ void jclass_exceptions_attribute_free(ExceptionsAttribute* attribute);
 InnerClassesAttribute* jclass_innerclasses_attribute_new(const AttributeContainer* container);
 void jclass_innerclasses_attribute_free(InnerClassesAttribute* attribute);
 
+BootstrapMethodsAttribute* jclass_bootstrapmethods_attribute_new(const AttributeContainer* container);
+void jclass_bootstrapmethods_attribute_free(BootstrapMethodsAttribute* attribute);
+
+NestHostAttribute* jclass_nesthost_attribute_new(const AttributeContainer* container);
+void jclass_nesthost_attribute_free(NestHostAttribute* attribute);
+
+NestMembersAttribute* jclass_nestmembers_attribute_new(const AttributeContainer* container);
+void jclass_nestmembers_attribute_free(NestMembersAttribute* attribute);
+
+RecordAttribute* jclass_record_attribute_new(const AttributeContainer* container);
+void jclass_record_attribute_free(RecordAttribute* attribute);
+
 CodeAttribute* jclass_code_attribute_new(const AttributeContainer* container);
 void jclass_code_attribute_free(CodeAttribute* attribute);
 
@@ -167,6 +167,20 @@ void jclass_class_free(JavaClass* class_struct)
 	free(class_struct);
 }
 
+/**
+* jclass_class_view_free
+* @view: A view filled by jclass_class_view_from_buffer() without an arena.
+*
+* Frees the constant pool arrays of a class view. The view itself is not freed.
+*/
+void jclass_class_view_free(JavaClassView* view)
+{
+	free(view->constant_pool.offsets);
+	view->constant_pool.offsets = NULL;
+	view->constant_pool.lengths = NULL;
+	view->constant_pool.tags = NULL;
+}
+
 /**
 * jclass_class_get_vm_spec
 * @javaclass: The class to get the VM spec for.
@@ -28,6 +28,7 @@
 
 #include <jclass/field.h>
 #include <jclass/class_loader.h>
+#include <jclass/arena.h>
 
 #define JAVA_CLASS_MAGIC 0xCAFEBABE
 
@@ -60,12 +61,58 @@ typedef struct {
 	AttributeContainer *attributes;
 } JavaClass;
 
+/* Why a length-checked parse failed */
+typedef enum {
+	JCLASS_OK = 0,
+	/* The buffer doesn't start with the class file magic */
+	JCLASS_ERROR_MAGIC,
+	/* A structure runs past the end of the buffer */
+	JCLASS_ERROR_TRUNCATED,
+	/* A constant pool entry has a tag of unknown size */
+	JCLASS_ERROR_CONSTANT_TAG,
+	/* malloc or the arena failed */
+	JCLASS_ERROR_MEMORY
+} JClassError;
+
+/* A class read in place, see jclass_class_view_from_buffer() */
+typedef struct {
+	uint16_t minor_version;
+	uint16_t major_version;
+	ConstantPoolView constant_pool;
+	uint16_t access_flags;
+	uint16_t interfaces_count;
+	uint16_t fields_count;
+	uint16_t methods_count;
+	uint16_t attributes_count;
+	/* Size of the class, or offset of the faulty structure after an error */
+	uint32_t offset;
+} JavaClassView;
+
+/* Sizes in bytes of the sections of a class file, as measured by a summary parse */
+typedef struct {
+	uint32_t constant_pool_size;
+	uint32_t interfaces_size;
+	/* field_info and method_info structures, their attributes included */
+	uint32_t fields_size;
+	uint32_t methods_size;
+	uint32_t attributes_size;
+	/* Number of attributes of all fields and all methods */
+	uint32_t field_attributes_count;
+	uint32_t method_attributes_count;
+} JavaClassSummary;
+
 JavaClass* jclass_class_new(const char *filename, const ClassPath* classpath);
 
 JavaClass* jclass_class_new_from_buffer(const char *data);
+JavaClass* jclass_class_new_from_buffer_in_arena(const char *data, JClassArena *arena);
+JavaClass* jclass_class_new_summary_from_buffer(const char *data, JavaClassSummary *summary, JClassArena *arena);
 JavaClass* jclass_class_new_from_file(FILE *classfile);
 void jclass_class_free(JavaClass *javaclass);
 
+JClassError jclass_class_view_from_buffer(const char *data, size_t size, JavaClassView *view, JClassArena *arena);
+void jclass_class_view_free(JavaClassView *view);
+const char* jclass_error_string(JClassError error);
+
 const char* jclass_class_get_vm_spec(const JavaClass *javaclass);
 char* jclass_class_get_class_name(const JavaClass *javaclass);
 char* jclass_class_get_super_class_name(const JavaClass *javaclass);
@@ -29,6 +29,10 @@
 #include <jclass/jstring.h>
 #include <jclass/class_loader.h>
 
+#ifndef _MSC_VER
+#define _snprintf snprintf
+#endif
+
 static void destroy_cp_info(ConstantPoolEntry*);
 
 /**
@@ -495,3 +499,66 @@ char* jclass_cp_get_constant_value(const ConstantPool* constant_pool, uint16_t c
 		
 	return value;
 }
+
+/**
+* jclass_cpview_get_utf8
+* @cpool: The constant pool view.
+* @index: The index of a CONSTANT_Utf8 entry.
+* @length: Set to the length of the string in bytes.
+*
+* Gives the contents of a UTF-8 entry without copying them.
+*
+* Returns: A pointer into the class bytes, not null terminated.
+* NULL if the entry is not a UTF-8 one.
+*/
+const char* jclass_cpview_get_utf8(const ConstantPoolView* cpool, uint16_t index, uint16_t* length)
+{
+	if(index == 0 || index >= cpool->count || cpool->tags[index] != CONSTANT_Utf8)
+		return NULL;
+	
+	*length = cpool->lengths[index];
+	return cpool->data + cpool->offsets[index];
+}
+
+/**
+* jclass_cpview_get_class_name
+* @cpool: The constant pool view.
+* @index: The index of a CONSTANT_Class entry.
+* @length: Set to the length of the name in bytes.
+*
+* Gives the internal name of a class (java/lang/String) without copying it,
+* converting '/' is left to the caller. An array of objects gives the name
+* of its element class.
+*
+* Returns: A pointer into the class bytes, not null terminated.
+* NULL if the entry is not a class or is an array of a primitive type.
+*/
+const char* jclass_cpview_get_class_name(const ConstantPoolView* cpool, uint16_t index, uint16_t* length)
+{
+	const uint8_t* entry;
+	const char* name;
+	uint16_t name_index;
+	
+	if(index == 0 || index >= cpool->count || cpool->tags[index] != CONSTANT_Class)
+		return NULL;
+	
+	entry = (const uint8_t*) (cpool->data + cpool->offsets[index]);
+	name_index = (uint16_t) ((entry[0] << 8) | entry[1]);
+	
+	name = jclass_cpview_get_utf8(cpool, name_index, length);
+	if(name == NULL || *length == 0 || name[0] != '[')
+		return name;
+	
+	while(*length > 0 && name[0] == '[')
+	{
+		name++;
+		(*length)--;
+	}
+	
+	/* Lelement/class; */
+	if(*length < 3 || name[0] != 'L' || name[*length - 1] != ';')
+		return NULL;
+	
+	*length -= 2;
+	return name + 1;
+}
@@ -42,7 +42,17 @@ typedef enum {
 	CONSTANT_Fieldref = 9,
 	CONSTANT_Methodref = 10,
 	CONSTANT_InterfaceMethodref = 11,
-	CONSTANT_NameAndType = 12
+	CONSTANT_NameAndType = 12,
+	/* Java 7 */
+	CONSTANT_MethodHandle = 15,
+	CONSTANT_MethodType = 16,
+	/* Java 11 */
+	CONSTANT_Dynamic = 17,
+	/* Java 7 */
+	CONSTANT_InvokeDynamic = 18,
+	/* Java 9, only in module-info classes */
+	CONSTANT_Module = 19,
+	CONSTANT_Package = 20
 } ConstantTag;
 
 typedef enum {
@@ -97,6 +107,34 @@ typedef struct {
     	uint16_t descriptor_index;
 } NameAndTypeEntry;
 
+typedef struct {
+		/* How the method handle behaves, 1 (getField) to 9 (invokeInterface) */
+		uint8_t reference_kind;
+		/* The index in the constant pool of the field/method reference. */
+		uint16_t reference_index;
+} MethodHandleEntry;
+
+typedef struct {
+		/* The index in the constant pool of the utf8_info entry 
+		* with the method descriptor.*/
+		uint16_t descriptor_index;
+} MethodTypeEntry;
+
+typedef struct {
+		/* The index in the BootstrapMethods attribute of the
+		* bootstrap method.*/
+		uint16_t bootstrap_method_attr_index;
+		/* The index in the constant pool of the NameAndTypeEntry 
+		* with the name and descriptor.*/
+		uint16_t name_and_type_index;
+} DynamicEntry;
+
+typedef struct {
+		/* The index in the constant pool of the utf8_info entry 
+		* with the name of the module/package.*/
+		uint16_t name_index;
+} ModuleEntry;
+
 typedef struct {
 		/* The length of the data in bytes */
     	uint16_t length;
@@ -116,6 +154,12 @@ typedef struct {
 			ReferenceEntry ref;
 			StringEntry stringinfo;
 			ClassEntry classinfo;
+			MethodHandleEntry methodhandle;
+			MethodTypeEntry methodtype;
+			/* CONSTANT_Dynamic and CONSTANT_InvokeDynamic */
+			DynamicEntry dynamic;
+			/* CONSTANT_Module and CONSTANT_Package */
+			ModuleEntry module;
 		}info;
 } ConstantPoolEntry;
 
@@ -130,6 +174,27 @@ typedef struct {
 	ConstantPoolEntry* entries;
 } ConstantPool;
 
+/* A constant pool read in place: nothing is copied out of the class bytes,
+ * every entry is located by its offset in them. One array per field.
+ */
+typedef struct {
+	/* The class bytes, they must outlive the view */
+	const char* data;
+	/* Number of entries */
+	uint16_t count;
+	/* The index of this class in the constant pool */
+	uint16_t this_class;
+	/* The index of the super class in the constant pool */
+	uint16_t super_class;
+	/* Offset in data of each entry, right after its tag
+	 * (after the length for a CONSTANT_Utf8) */
+	uint32_t* offsets;
+	/* Length of each CONSTANT_Utf8, 0 for the other entries */
+	uint16_t* lengths;
+	/* Tag of each entry */
+	uint8_t* tags;
+} ConstantPoolView;
+
 
 ConstantPool* jclass_cp_new(const char* filename, const ClassPath *classpath);
 ConstantPool* jclass_cp_new_from_buffer(const char* data);
@@ -144,6 +209,9 @@ char* jclass_cp_get_method_signature(const ConstantPool* cpool, uint16_t index,
 char* jclass_cp_get_constant_value(const ConstantPool* cpool, uint16_t index, IntType int_type);
 ConstantTag jclass_cp_get_entry_type(const ConstantPool* cpool, uint16_t index);
 
+const char* jclass_cpview_get_utf8(const ConstantPoolView* cpool, uint16_t index, uint16_t* length);
+const char* jclass_cpview_get_class_name(const ConstantPoolView* cpool, uint16_t index, uint16_t* length);
+
 #ifdef _cplusplus
  }
 #endif 
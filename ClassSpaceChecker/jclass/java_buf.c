@@ -27,14 +27,33 @@
 #include <string.h>
 
 #include <jclass/class.h>
+#include <jclass/arena.h>
 
+static void* buf_alloc(JClassArena*, size_t);
 static uint16_t read_uint16(const char**);
 static uint32_t read_uint32(const char**);
-static ConstantPool* read_constant_pool(const char**);
-static void get_next_entry(ConstantPoolEntry*, const char**);
-static uint16_t* read_interfaces(const char**, uint16_t);
-static Field* read_fields(const char**, uint16_t);
-static AttributeContainer* read_attributes(const char**, uint16_t);
+static ConstantPool* read_constant_pool(const char**, JClassArena*);
+static JClassError read_constant_pool_view(const char**, const char*, const char*, ConstantPoolView*, JClassArena*);
+static void get_next_entry(ConstantPoolEntry*, const char**, JClassArena*);
+static uint16_t* read_interfaces(const char**, uint16_t, JClassArena*);
+static Field* read_fields(const char**, uint16_t, JClassArena*);
+static AttributeContainer* read_attributes(const char**, uint16_t, JClassArena*);
+static JClassError skip_fields(const char**, const char*, uint16_t, uint32_t*);
+static JClassError skip_attributes(const char**, const char*, uint16_t);
+
+/* Whether n more bytes can be read before end, a NULL end doesn't limit anything.
+ * Checked once per structure, its fields are then read without checks.
+ */
+#define BUF_FITS(buf, end, n) ((end) == NULL || (size_t) ((end) - (buf)) >= (size_t) (n))
+
+/* Everything a parse allocates comes from the arena when there is one */
+static void* buf_alloc(JClassArena* arena, size_t size)
+{
+	if(arena != NULL)
+		return jclass_arena_alloc(arena, size);
+	
+	return malloc(size);
+}
 
 static uint16_t read_uint16(const char** buf)
 {
@@ -62,10 +81,30 @@ static uint32_t read_uint32(const char** buf)
 *
 * Creates a JavaClass struct from the given buffer.
 * The buffer should be in the same format as a class file.
+* Its size isn't known so nothing is checked: only use it on classes that
+* are known to be valid, jclass_class_view_from_buffer() checks the bounds.
 *
-* Returns: A JavaClass struct allocated with malloc.
+* Returns: A JavaClass struct allocated with malloc, NULL if it isn't a
+* class file or malloc failed.
 */
 JavaClass* jclass_class_new_from_buffer(const char* data)
+{
+	return jclass_class_new_from_buffer_in_arena(data, NULL);
+}
+
+/**
+* jclass_class_new_from_buffer_in_arena
+* @data: The buffer containing the class.
+* @arena: The arena everything is allocated from. Can be NULL.
+*
+* Same as jclass_class_new_from_buffer() but the whole class is allocated
+* from the arena: do not call jclass_class_free() on it, it is released
+* with the arena. With a NULL arena the class is allocated with malloc.
+*
+* Returns: A JavaClass struct, NULL if it isn't a class file or the
+* memory couldn't be allocated.
+*/
+JavaClass* jclass_class_new_from_buffer_in_arena(const char* data, JClassArena* arena)
 {
 	JavaClass* class_struct;
 	const char* buf = data;
@@ -76,32 +115,242 @@ JavaClass* jclass_class_new_from_buffer(const char* data)
 	if (read_uint32(&buf) != JAVA_CLASS_MAGIC)
 		return NULL;
 	
-	class_struct = (JavaClass*) malloc(sizeof(JavaClass));
+	class_struct = (JavaClass*) buf_alloc(arena, sizeof(JavaClass));
+	if(class_struct == NULL)
+		return NULL;
 	
 	class_struct->minor_version = read_uint16(&buf);
 	class_struct->major_version = read_uint16(&buf);
 	
-	class_struct->constant_pool = read_constant_pool(&buf);
+	class_struct->constant_pool = read_constant_pool(&buf, arena);
+	if(class_struct->constant_pool == NULL)
+	{
+		if(arena == NULL)
+			free(class_struct);
+		return NULL;
+	}
 	
 	class_struct->access_flags = read_uint16(&buf);
 	class_struct->constant_pool->this_class = read_uint16(&buf);
 	class_struct->constant_pool->super_class = read_uint16(&buf);
 	
 	class_struct->interfaces_count = read_uint16(&buf);
-	class_struct->interfaces = read_interfaces(&buf, class_struct->interfaces_count);
+	class_struct->interfaces = read_interfaces(&buf, class_struct->interfaces_count, arena);
 	
 	class_struct->fields_count = read_uint16(&buf);
-	class_struct->fields = read_fields(&buf, class_struct->fields_count);
+	class_struct->fields = read_fields(&buf, class_struct->fields_count, arena);
 	
 	class_struct->methods_count = read_uint16(&buf);
-	class_struct->methods = read_fields(&buf, class_struct->methods_count);
+	class_struct->methods = read_fields(&buf, class_struct->methods_count, arena);
 	
 	class_struct->attributes_count = read_uint16(&buf);
-	class_struct->attributes = read_attributes(&buf, class_struct->attributes_count);
+	class_struct->attributes = read_attributes(&buf, class_struct->attributes_count, arena);
 
 	return class_struct;
 }
 
+/**
+* jclass_class_new_summary_from_buffer
+* @data: The buffer containing the class.
+* @summary: Filled with the section sizes of the class. Can be NULL.
+* @arena: The arena everything is allocated from. Can be NULL.
+*
+* Creates a JavaClass struct from the given buffer, reading only the
+* constant pool, the interfaces and the counts of the other sections.
+* Fields, methods and attributes are stepped over by their length without
+* being allocated: their pointers are NULL, their counts are set.
+* With an arena, the class is released with it, not jclass_class_free().
+*
+* Returns: A JavaClass struct, NULL if it isn't a class file or the
+* memory couldn't be allocated.
+*/
+JavaClass* jclass_class_new_summary_from_buffer(const char* data, JavaClassSummary* summary, JClassArena* arena)
+{
+	JavaClass* class_struct;
+	const char* buf = data;
+	const char* section;
+	uint32_t field_attributes_count;
+	uint32_t method_attributes_count;
+	
+	if(data == NULL)
+		return NULL;
+	
+	if (read_uint32(&buf) != JAVA_CLASS_MAGIC)
+		return NULL;
+	
+	class_struct = (JavaClass*) buf_alloc(arena, sizeof(JavaClass));
+	if(class_struct == NULL)
+		return NULL;
+	
+	class_struct->minor_version = read_uint16(&buf);
+	class_struct->major_version = read_uint16(&buf);
+	
+	section = buf;
+	class_struct->constant_pool = read_constant_pool(&buf, arena);
+	if(class_struct->constant_pool == NULL)
+	{
+		if(arena == NULL)
+			free(class_struct);
+		return NULL;
+	}
+	if(summary != NULL)
+		summary->constant_pool_size = (uint32_t) (buf - section);
+	
+	class_struct->access_flags = read_uint16(&buf);
+	class_struct->constant_pool->this_class = read_uint16(&buf);
+	class_struct->constant_pool->super_class = read_uint16(&buf);
+	
+	section = buf;
+	class_struct->interfaces_count = read_uint16(&buf);
+	class_struct->interfaces = read_interfaces(&buf, class_struct->interfaces_count, arena);
+	if(summary != NULL)
+		summary->interfaces_size = (uint32_t) (buf - section);
+	
+	section = buf;
+	class_struct->fields_count = read_uint16(&buf);
+	class_struct->fields = NULL;
+	skip_fields(&buf, NULL, class_struct->fields_count, &field_attributes_count);
+	if(summary != NULL)
+	{
+		summary->fields_size = (uint32_t) (buf - section);
+		summary->field_attributes_count = field_attributes_count;
+	}
+	
+	section = buf;
+	class_struct->methods_count = read_uint16(&buf);
+	class_struct->methods = NULL;
+	skip_fields(&buf, NULL, class_struct->methods_count, &method_attributes_count);
+	if(summary != NULL)
+	{
+		summary->methods_size = (uint32_t) (buf - section);
+		summary->method_attributes_count = method_attributes_count;
+	}
+	
+	section = buf;
+	class_struct->attributes_count = read_uint16(&buf);
+	class_struct->attributes = NULL;
+	skip_attributes(&buf, NULL, class_struct->attributes_count);
+	if(summary != NULL)
+		summary->attributes_size = (uint32_t) (buf - section);
+
+	return class_struct;
+}
+
+/**
+* jclass_class_view_from_buffer
+* @data: The buffer containing the class.
+* @size: The size of the buffer.
+* @view: The view to fill.
+* @arena: The arena the constant pool arrays are allocated from. Can be NULL.
+*
+* Reads a class in place. The constant pool entries are located in data
+* and nothing is copied: data must outlive the view. The other sections
+* are only counted. The constant pool index arrays are the only allocation,
+* without an arena they are released by jclass_class_view_free().
+* Nothing is read past size: every structure is checked to fit before it
+* is read. view->offset is the size of the class or, on error, where the
+* faulty structure starts.
+*
+* Returns: JCLASS_OK, or the reason the buffer is not a valid class.
+* On error there is nothing to free.
+*/
+JClassError jclass_class_view_from_buffer(const char* data, size_t size, JavaClassView* view, JClassArena* arena)
+{
+	const char* buf = data;
+	const char* end = data + size;
+	JClassError error;
+	
+	view->offset = 0;
+	view->constant_pool.offsets = NULL;
+	
+	if(data == NULL)
+		return JCLASS_ERROR_TRUNCATED;
+	
+	/* magic, versions and constant_pool_count */
+	if(!BUF_FITS(buf, end, 10))
+		return JCLASS_ERROR_TRUNCATED;
+	
+	if (read_uint32(&buf) != JAVA_CLASS_MAGIC)
+		return JCLASS_ERROR_MAGIC;
+	
+	view->minor_version = read_uint16(&buf);
+	view->major_version = read_uint16(&buf);
+	
+	error = read_constant_pool_view(&buf, end, data, &view->constant_pool, arena);
+	
+	/* access_flags, this_class, super_class and interfaces_count */
+	if(error == JCLASS_OK && !BUF_FITS(buf, end, 8))
+		error = JCLASS_ERROR_TRUNCATED;
+	
+	if(error == JCLASS_OK)
+	{
+		view->access_flags = read_uint16(&buf);
+		view->constant_pool.this_class = read_uint16(&buf);
+		view->constant_pool.super_class = read_uint16(&buf);
+		
+		view->interfaces_count = read_uint16(&buf);
+		if(!BUF_FITS(buf, end, 2 * view->interfaces_count + 2))
+			error = JCLASS_ERROR_TRUNCATED;
+	}
+	
+	if(error == JCLASS_OK)
+	{
+		buf += 2 * view->interfaces_count;
+		
+		view->fields_count = read_uint16(&buf);
+		error = skip_fields(&buf, end, view->fields_count, NULL);
+	}
+	
+	if(error == JCLASS_OK && !BUF_FITS(buf, end, 2))
+		error = JCLASS_ERROR_TRUNCATED;
+	
+	if(error == JCLASS_OK)
+	{
+		view->methods_count = read_uint16(&buf);
+		error = skip_fields(&buf, end, view->methods_count, NULL);
+	}
+	
+	if(error == JCLASS_OK && !BUF_FITS(buf, end, 2))
+		error = JCLASS_ERROR_TRUNCATED;
+	
+	if(error == JCLASS_OK)
+	{
+		view->attributes_count = read_uint16(&buf);
+		error = skip_attributes(&buf, end, view->attributes_count);
+	}
+	
+	view->offset = (uint32_t) (buf - data);
+	
+	if(error != JCLASS_OK && arena == NULL && view->constant_pool.offsets != NULL)
+		jclass_class_view_free(view);
+	
+	return error;
+}
+
+/**
+* jclass_error_string
+* @error: An error returned by a parse.
+*
+* Returns: A statically allocated description of the error.
+*/
+const char* jclass_error_string(JClassError error)
+{
+	switch(error)
+	{
+		case JCLASS_OK:
+			return "No error";
+		case JCLASS_ERROR_MAGIC:
+			return "Not a class file";
+		case JCLASS_ERROR_TRUNCATED:
+			return "Truncated class file";
+		case JCLASS_ERROR_CONSTANT_TAG:
+			return "Unknown constant pool tag";
+		case JCLASS_ERROR_MEMORY:
+			return "Out of memory";
+	}
+	return "Unknown error";
+}
+
 /**
 * jclass_cp_new_from_buffer
 * @data: A memory buffer containing a class file.
@@ -124,7 +373,7 @@ ConstantPool* jclass_cp_new_from_buffer(const char* data)
 	read_uint16(&buf);
 	read_uint16(&buf);
 	
-	cp = read_constant_pool(&buf);
+	cp = read_constant_pool(&buf, NULL);
 	
 	read_uint16(&buf);
 	
@@ -134,21 +383,30 @@ ConstantPool* jclass_cp_new_from_buffer(const char* data)
 	return cp;
 }
 
-static ConstantPool* read_constant_pool(const char** buf)
+static ConstantPool* read_constant_pool(const char** buf, JClassArena* arena)
 {
 	ConstantPool* constant_pool;
 	uint16_t count = 0;
 				
-	constant_pool = (ConstantPool*) malloc(sizeof(ConstantPool));
+	constant_pool = (ConstantPool*) buf_alloc(arena, sizeof(ConstantPool));
+	if(constant_pool == NULL)
+		return NULL;
+	
 	constant_pool->count = read_uint16(buf);
-	constant_pool->entries = (ConstantPoolEntry*) malloc(sizeof(ConstantPoolEntry) * constant_pool->count);
+	constant_pool->entries = (ConstantPoolEntry*) buf_alloc(arena, sizeof(ConstantPoolEntry) * constant_pool->count);
+	if(constant_pool->entries == NULL)
+	{
+		if(arena == NULL)
+			free(constant_pool);
+		return NULL;
+	}
 	
 	constant_pool->entries[0].tag = CONSTANT_Empty;
 	
 	do
 	{
 		count++;
-	 	get_next_entry(&(constant_pool->entries[count]), buf);
+	 	get_next_entry(&(constant_pool->entries[count]), buf, arena);
 		
 		if (constant_pool->entries[count].tag != CONSTANT_Empty)
 		{
@@ -169,7 +427,123 @@ static ConstantPool* read_constant_pool(const char** buf)
 	return constant_pool;
 }
 
-static void get_next_entry(ConstantPoolEntry* info, const char** buf)
+/* Locates the entries of the constant pool in data. All three arrays share one allocation.
+ * On error *buf is left on the faulty entry.
+ */
+static JClassError read_constant_pool_view(const char** buf, const char* end, const char* data, ConstantPoolView* cpool, JClassArena* arena)
+{
+	char* arrays;
+	const char* entry;
+	uint16_t length;
+	uint8_t tag;
+	int count;
+	
+	cpool->data = data;
+	cpool->count = read_uint16(buf);
+	
+	arrays = (char*) buf_alloc(arena, cpool->count * (sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint8_t)));
+	if(arrays == NULL)
+		return JCLASS_ERROR_MEMORY;
+	
+	cpool->offsets = (uint32_t*) arrays;
+	cpool->lengths = (uint16_t*) (arrays + cpool->count * sizeof(uint32_t));
+	cpool->tags = (uint8_t*) (arrays + cpool->count * (sizeof(uint32_t) + sizeof(uint16_t)));
+	
+	for(count = 0; count < cpool->count; count++)
+	{
+		cpool->offsets[count] = 0;
+		cpool->lengths[count] = 0;
+		cpool->tags[count] = CONSTANT_Empty;
+		if(count == 0)
+			continue;
+		
+		/* the tag and the fixed part of the entry are checked at once */
+		entry = *buf;
+		if(!BUF_FITS(entry, end, 3))
+			return JCLASS_ERROR_TRUNCATED;
+		
+		tag = (uint8_t) *entry;
+		(*buf)++;
+		
+		cpool->tags[count] = tag;
+		cpool->offsets[count] = (uint32_t) (*buf - data);
+		
+		switch(tag)
+		{
+			case CONSTANT_Utf8:
+				length = read_uint16(buf);
+				if(!BUF_FITS(*buf, end, length))
+				{
+					*buf = entry;
+					return JCLASS_ERROR_TRUNCATED;
+				}
+				cpool->offsets[count] += 2;
+				cpool->lengths[count] = length;
+				(*buf) += length;
+				break;
+			
+			case CONSTANT_Class:
+			case CONSTANT_String:
+			case CONSTANT_MethodType:
+			case CONSTANT_Module:
+			case CONSTANT_Package:
+				(*buf) += 2;
+				break;
+			
+			case CONSTANT_MethodHandle:
+				if(!BUF_FITS(*buf, end, 3))
+				{
+					*buf = entry;
+					return JCLASS_ERROR_TRUNCATED;
+				}
+				(*buf) += 3;
+				break;
+			
+			case CONSTANT_Fieldref:
+			case CONSTANT_Methodref:
+			case CONSTANT_InterfaceMethodref:
+			case CONSTANT_Integer:
+			case CONSTANT_Float:
+			case CONSTANT_NameAndType:
+			case CONSTANT_Dynamic:
+			case CONSTANT_InvokeDynamic:
+				if(!BUF_FITS(*buf, end, 4))
+				{
+					*buf = entry;
+					return JCLASS_ERROR_TRUNCATED;
+				}
+				(*buf) += 4;
+				break;
+			
+			case CONSTANT_Long:
+			case CONSTANT_Double:
+				if(!BUF_FITS(*buf, end, 8))
+				{
+					*buf = entry;
+					return JCLASS_ERROR_TRUNCATED;
+				}
+				(*buf) += 8;
+				/* For every double or long the next entry is reserved for the VM */
+				if(count + 1 < cpool->count)
+				{
+					count++;
+					cpool->offsets[count] = 0;
+					cpool->lengths[count] = 0;
+					cpool->tags[count] = CONSTANT_Empty;
+				}
+				break;
+			
+			default:
+				/* the size of the entry is unknown, nothing after it can be located */
+				*buf = entry;
+				return JCLASS_ERROR_CONSTANT_TAG;
+		}
+	}
+	
+	return JCLASS_OK;
+}
+
+static void get_next_entry(ConstantPoolEntry* info, const char** buf, JClassArena* arena)
 {
 	memcpy(&info->tag, *buf, 1);
 	(*buf)++;
@@ -198,7 +572,7 @@ static void get_next_entry(ConstantPoolEntry* info, const char** buf)
 
 		case CONSTANT_Long:
 		case CONSTANT_Double:
-			info->info.longinfo = (LongEntry*) malloc(sizeof(LongEntry));
+			info->info.longinfo = (LongEntry*) buf_alloc(arena, sizeof(LongEntry));
 			info->info.longinfo->long_bytes = ((uint64_t) read_uint32(buf)) << 32;
 			info->info.longinfo->long_bytes += read_uint32(buf);
 			break;
@@ -208,12 +582,33 @@ static void get_next_entry(ConstantPoolEntry* info, const char** buf)
 			info->info.nameandtype.descriptor_index = read_uint16(buf);
 			break;
 
+		case CONSTANT_MethodHandle:
+			memcpy(&info->info.methodhandle.reference_kind, *buf, 1);
+			(*buf)++;
+			info->info.methodhandle.reference_index = read_uint16(buf);
+			break;
+
+		case CONSTANT_MethodType:
+			info->info.methodtype.descriptor_index = read_uint16(buf);
+			break;
+
+		case CONSTANT_Dynamic:
+		case CONSTANT_InvokeDynamic:
+			info->info.dynamic.bootstrap_method_attr_index = read_uint16(buf);
+			info->info.dynamic.name_and_type_index = read_uint16(buf);
+			break;
+
+		case CONSTANT_Module:
+		case CONSTANT_Package:
+			info->info.module.name_index = read_uint16(buf);
+			break;
+
 		case CONSTANT_Utf8:
-			info->info.utf8 = (UTF8Entry*) malloc(sizeof(UTF8Entry));
+			info->info.utf8 = (UTF8Entry*) buf_alloc(arena, sizeof(UTF8Entry));
 			info->info.utf8->length = read_uint16(buf);
 			if(info->info.utf8->length)
 			{
-				info->info.utf8->contents = (uint8_t*) malloc(sizeof(uint8_t) * info->info.utf8->length);
+				info->info.utf8->contents = (uint8_t*) buf_alloc(arena, sizeof(uint8_t) * info->info.utf8->length);
 				memcpy(info->info.utf8->contents, *buf, info->info.utf8->length);
 				(*buf) += info->info.utf8->length;
 			}
@@ -228,7 +623,7 @@ static void get_next_entry(ConstantPoolEntry* info, const char** buf)
 		}
 }
 
-static uint16_t* read_interfaces(const char** buf, uint16_t count)
+static uint16_t* read_interfaces(const char** buf, uint16_t count, JClassArena* arena)
 {
 	uint16_t* interfaces;
 	uint16_t i;
@@ -237,7 +632,7 @@ static uint16_t* read_interfaces(const char** buf, uint16_t count)
 		return NULL;
 	
 	if(count)
-		interfaces = (uint16_t*) malloc(sizeof(uint16_t) * count);
+		interfaces = (uint16_t*) buf_alloc(arena, sizeof(uint16_t) * count);
 	else
 		interfaces = NULL;
 	
@@ -247,14 +642,14 @@ static uint16_t* read_interfaces(const char** buf, uint16_t count)
 	return interfaces;
 }
 
-static Field* read_fields(const char** buf, uint16_t count)
+static Field* read_fields(const char** buf, uint16_t count, JClassArena* arena)
 {
 	Field* field_array;
 	uint16_t i;
 	
 	if(count)
 	{
-		field_array = (Field*) malloc(sizeof(Field) * count);
+		field_array = (Field*) buf_alloc(arena, sizeof(Field) * count);
 		
 		for(i=0; i < count; i++)
 		{
@@ -263,7 +658,7 @@ static Field* read_fields(const char** buf, uint16_t count)
 			field_array[i].descriptor_index = read_uint16(buf);
 			field_array[i].attributes_count = read_uint16(buf);
 			
-			field_array[i].attributes = read_attributes(buf, field_array[i].attributes_count);
+			field_array[i].attributes = read_attributes(buf, field_array[i].attributes_count, arena);
 		}
 	}
 	else
@@ -272,7 +667,7 @@ static Field* read_fields(const char** buf, uint16_t count)
 	return field_array;
 }
 
-static AttributeContainer* read_attributes(const char** buf, uint16_t count)
+static AttributeContainer* read_attributes(const char** buf, uint16_t count, JClassArena* arena)
 {
 	AttributeContainer* attributes;
 	int j;
@@ -280,7 +675,7 @@ static AttributeContainer* read_attributes(const char** buf, uint16_t count)
 	if(count == 0)
 		return NULL;
 	
-	attributes = (AttributeContainer*) malloc(sizeof(AttributeContainer) * count);
+	attributes = (AttributeContainer*) buf_alloc(arena, sizeof(AttributeContainer) * count);
 						
 	for(j=0; j < count; j++)
 	{
@@ -289,7 +684,7 @@ static AttributeContainer* read_attributes(const char** buf, uint16_t count)
 		
 		if(attributes[j].length)
 		{
-			attributes[j].contents = (uint8_t*) malloc(sizeof(uint8_t) * attributes[j].length);
+			attributes[j].contents = (uint8_t*) buf_alloc(arena, sizeof(uint8_t) * attributes[j].length);
 			memcpy(attributes[j].contents, *buf, attributes[j].length);
 			(*buf) += attributes[j].length;
 		}
@@ -299,3 +694,58 @@ static AttributeContainer* read_attributes(const char** buf, uint16_t count)
 	
 	return attributes;
 }
+
+/* Steps over count field_info or method_info structures and their attributes,
+ * adding the number of attributes to attributes_count. end can be NULL.
+ */
+static JClassError skip_fields(const char** buf, const char* end, uint16_t count, uint32_t* attributes_count)
+{
+	uint16_t field_attributes_count;
+	JClassError error;
+	uint16_t i;
+	
+	if(attributes_count != NULL)
+		*attributes_count = 0;
+	
+	for(i=0; i < count; i++)
+	{
+		/* access_flags, name_index, descriptor_index and attributes_count */
+		if(!BUF_FITS(*buf, end, 8))
+			return JCLASS_ERROR_TRUNCATED;
+		
+		(*buf) += 6;
+		field_attributes_count = read_uint16(buf);
+		error = skip_attributes(buf, end, field_attributes_count);
+		if(error != JCLASS_OK)
+			return error;
+		
+		if(attributes_count != NULL)
+			*attributes_count += field_attributes_count;
+	}
+	
+	return JCLASS_OK;
+}
+
+static JClassError skip_attributes(const char** buf, const char* end, uint16_t count)
+{
+	uint32_t length;
+	int j;
+	
+	for(j=0; j < count; j++)
+	{
+		/* name_index and length */
+		if(!BUF_FITS(*buf, end, 6))
+			return JCLASS_ERROR_TRUNCATED;
+		
+		(*buf) += 2;
+		length = read_uint32(buf);
+		if(!BUF_FITS(*buf, end, length))
+		{
+			(*buf) -= 6;
+			return JCLASS_ERROR_TRUNCATED;
+		}
+		(*buf) += length;
+	}
+	
+	return JCLASS_OK;
+}
@@ -3,7 +3,12 @@
  *
 */
 
+/* the bundled inttypes.h is only for Visual C++, which doesn't have one */
+#ifdef _MSC_VER
 #define JCLASS_INTTYPES_H "inttypes.h"
+#else
+#define JCLASS_INTTYPES_H <inttypes.h>
+#endif
 /* #undef JCLASS_BIGENDIAN */
 #define JCLASS_CURRENT 3
 #define JCLASS_RELEASE 1
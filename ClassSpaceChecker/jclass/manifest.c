@@ -214,7 +214,7 @@ static const ManifestSection *get_section(const Manifest *manifest, const char *
 	for (i = 0; i < manifest->section_count; i++) {
 		if (!section && !manifest->sections[i].name)
 			return &manifest->sections[i];
-		if (manifest->sections[i].name && strcmp(manifest->sections[i].name, section))
+		if (section && manifest->sections[i].name && !strcmp(manifest->sections[i].name, section))
 			return &manifest->sections[i];
 	}
 	return NULL;
@@ -0,0 +1,823 @@
+#include <QtCore>
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(_MSC_VER) && defined(_DEBUG)
+#include <crtdbg.h>
+#endif
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+#include "XZip/JarReader.h"
+#include "jclass/jclass.h"
+#include "jclass/arena.h"
+#include "JarLoader.h"
+#include "JarAnalyzer.h"
+
+#define METHOD_DEFLATED		8		// JarEntry::method
+
+// Benchmarks of the analysis stages, run on the jars given (e.g. the ones mkjar.py writes).
+// Every benchmark prints one line per variant, times are the best of --rounds runs.
+
+// malloc() calls and bytes while countAllocations is set, seen through the debug CRT of Visual C++
+// or by standing in for the malloc() of glibc. They stay at 0 on the other platforms.
+// Only set around single threaded loops, the counters aren't atomic.
+static bool countAllocations = false;
+static qint64 allocationCount = 0;
+static qint64 allocatedBytes = 0;
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+static int allocHook(int allocType, void *, size_t size, int, long, const unsigned char *, int)
+{
+	if(countAllocations && allocType == _HOOK_ALLOC)
+	{
+		allocationCount++;
+		allocatedBytes += size;
+	}
+	return 1;
+}
+#define ALLOCATION_COUNTS
+#elif defined(__GLIBC__)
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *malloc(size_t size) throw()
+{
+	if(countAllocations)
+	{
+		allocationCount++;
+		allocatedBytes += size;
+	}
+	return __libc_malloc(size);
+}
+#define ALLOCATION_COUNTS
+#endif
+
+// resident memory of the process, 0 where it isn't known
+static qint64 processMemory()
+{
+#if defined(Q_OS_WIN)
+	PROCESS_MEMORY_COUNTERS counters;
+	if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.WorkingSetSize;
+#elif defined(Q_OS_LINUX)
+	FILE *statm = fopen("/proc/self/statm", "r");
+	if(statm != NULL)
+	{
+		long size = 0;
+		long resident = 0;
+		int read = fscanf(statm, "%ld %ld", &size, &resident);
+		fclose(statm);
+		if(read == 2)
+			return (qint64)resident * sysconf(_SC_PAGESIZE);
+	}
+#endif
+	return 0;
+}
+
+static void printUsage()
+{
+	fprintf(stderr,
+		"Usage: ClassSpaceCheckerBench <benchmark> [options] <jar file>...\n"
+		"Benchmarks:\n"
+		"  ingest               temp file round trip against in memory parse of the .class entries\n"
+		"  load                 JarLoader on 1, 2, 4 ... threads, classes/s and MB/s\n"
+		"  inflate              MB/s of every inflate backend built in, on the DEFLATE entries\n"
+		"  parse                full and summary parses of the .class entries, with malloc and with an arena,\n"
+		"                       time and mallocs per class\n"
+		"  collect              JarAnalyzer load and collect times, symbol table and process memory\n"
+		"  references           reference counting time per reference, to compare jars of 1k/10k/100k classes\n"
+		"  table                class table footprint, search and column scan times\n"
+		"  cache                every entry read through the entry cache against all of them kept,\n"
+		"                       bytes retained per class and process memory\n"
+		"Options:\n"
+		"  --rounds <n>         runs of each variant, the fastest one is reported (default 3)\n"
+		"  --threads <n>        most threads of the load benchmark (default all cores)\n"
+		"  --cache-mb <n>       entry cache of the cache benchmark (default 32)\n");
+}
+
+static double perSecond(qint64 count, qint64 nsecs)
+{
+	return nsecs > 0 ? count * 1e9 / nsecs : 0;
+}
+
+// The way loadJarFile() read a class before the jar was read in memory : the entry is
+// written to the temp directory, read back for the source view, parsed from the file and deleted.
+static bool ingestThroughTempFile(const QByteArray &bytes, const QString &tempPath)
+{
+	QFile output(tempPath);
+	if(!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+	output.write(bytes);
+	output.close();
+
+	QFile input(tempPath);
+	if(!input.open(QIODevice::ReadOnly))
+		return false;
+	QByteArray buffer = input.readAll();
+	input.close();
+
+	JavaClass *clazz = jclass_class_new(QFile::encodeName(tempPath).constData(), NULL);
+	if(clazz != NULL)
+		jclass_class_free(clazz);
+
+	QFile::remove(tempPath);
+	return clazz != NULL && buffer.size() == bytes.size();
+}
+
+static bool benchIngest(const QString &jarPath, int rounds)
+{
+	JarReader reader;
+	if(!reader.open(jarPath))
+	{
+		fprintf(stderr, "%s\n", reader.errorString().toLocal8Bit().constData());
+		return false;
+	}
+
+	QVector<int> classEntries;
+	for(int i = 0; i < reader.count(); i++)
+	{
+		if(reader.entry(i).name.endsWith(".class", Qt::CaseInsensitive))
+			classEntries.append(i);
+	}
+
+	QString tempPath = QDir::tempPath() + "/ClassSpaceCheckerBench.class";
+	qint64 bestTempFile = -1;
+	qint64 bestMemory = -1;
+	qint64 totalBytes = 0;
+	for(int round = 0; round < rounds; round++)
+	{
+		QElapsedTimer timer;
+		timer.start();
+		for(int i = 0; i < classEntries.size(); i++)
+		{
+			if(!ingestThroughTempFile(reader.read(classEntries.at(i)), tempPath))
+			{
+				fprintf(stderr, "Failed to read %s through %s\n", reader.entry(classEntries.at(i)).name.toLocal8Bit().constData(),
+					tempPath.toLocal8Bit().constData());
+				return false;
+			}
+		}
+		qint64 elapsed = timer.nsecsElapsed();
+		if(bestTempFile < 0 || elapsed < bestTempFile)
+			bestTempFile = elapsed;
+
+		// what JarLoader does : STORED entries are parsed in the mapping, DEFLATE ones in one reused buffer
+		QByteArray entryBuffer;
+		totalBytes = 0;
+		timer.start();
+		for(int i = 0; i < classEntries.size(); i++)
+		{
+			const char *data;
+			qint64 size;
+			if(!reader.read(classEntries.at(i), &data, &size, entryBuffer))
+				continue;
+			JavaClass *clazz = jclass_class_new_from_buffer(data);
+			if(clazz != NULL)
+				jclass_class_free(clazz);
+			totalBytes += size;
+		}
+		elapsed = timer.nsecsElapsed();
+		if(bestMemory < 0 || elapsed < bestMemory)
+			bestMemory = elapsed;
+	}
+
+	printf("ingest %s : %d classes, %lld bytes\n", jarPath.toLocal8Bit().constData(), classEntries.size(), totalBytes);
+	printf("  temp file  %9.1f ms %10.0f classes/s\n", bestTempFile / 1e6, perSecond(classEntries.size(), bestTempFile));
+	printf("  memory     %9.1f ms %10.0f classes/s\n", bestMemory / 1e6, perSecond(classEntries.size(), bestMemory));
+	return true;
+}
+
+static bool benchLoad(const QString &jarPath, int rounds, int maxThreads)
+{
+	JarReader reader;
+	if(!reader.open(jarPath))
+	{
+		fprintf(stderr, "%s\n", reader.errorString().toLocal8Bit().constData());
+		return false;
+	}
+
+	printf("load %s : %d entries\n", jarPath.toLocal8Bit().constData(), reader.count());
+	qint64 singleThread = -1;
+	for(int threads = 1; ; threads = qMin(threads * 2, maxThreads))
+	{
+		qint64 best = -1;
+		int classCount = 0;
+		qint64 totalBytes = 0;
+		int threadCount = 0;
+		for(int round = 0; round < rounds; round++)
+		{
+			SymbolTable symbols;
+			ClassTable classes;
+			JarLoader loader(reader, symbols);
+			loader.setMaxThreadCount(threads);
+
+			QElapsedTimer timer;
+			timer.start();
+			loader.load(classes);
+			qint64 elapsed = timer.nsecsElapsed();
+			if(best < 0 || elapsed < best)
+				best = elapsed;
+
+			classCount = classes.size();
+			totalBytes = loader.totalBytes();
+			threadCount = loader.threadCount();
+		}
+		if(singleThread < 0)
+			singleThread = best;
+
+		printf("  %2d threads %9.1f ms %10.0f classes/s %8.1f MB/s  x%.2f\n", threadCount, best / 1e6,
+			perSecond(classCount, best), perSecond(totalBytes, best) / (1024 * 1024), (double)singleThread / best);
+		if(threads >= maxThreads)
+			break;
+	}
+	return true;
+}
+
+static bool benchInflate(const QString &jarPath, int rounds)
+{
+	JarReader reader;
+	if(!reader.open(jarPath))
+	{
+		fprintf(stderr, "%s\n", reader.errorString().toLocal8Bit().constData());
+		return false;
+	}
+
+	QVector<int> deflatedEntries;
+	qint64 compressedBytes = 0;
+	qint64 uncompressedBytes = 0;
+	for(int i = 0; i < reader.count(); i++)
+	{
+		const JarEntry &entry = reader.entry(i);
+		if(entry.method != METHOD_DEFLATED)
+			continue;
+		deflatedEntries.append(i);
+		compressedBytes += entry.compressedSize;
+		uncompressedBytes += entry.uncompressedSize;
+	}
+
+	printf("inflate %s : %d deflated entries, %lld -> %lld bytes\n", jarPath.toLocal8Bit().constData(),
+		deflatedEntries.size(), compressedBytes, uncompressedBytes);
+
+	QList<const InflateBackend *> backends = InflateBackend::backends();
+	for(int b = 0; b < backends.size(); b++)
+	{
+		reader.setInflateBackend(backends.at(b));
+
+		QByteArray entryBuffer;
+		qint64 best = -1;
+		int failedCount = 0;
+		for(int round = 0; round < rounds; round++)
+		{
+			failedCount = 0;
+			QElapsedTimer timer;
+			timer.start();
+			for(int i = 0; i < deflatedEntries.size(); i++)
+			{
+				const char *data;
+				qint64 size;
+				if(!reader.read(deflatedEntries.at(i), &data, &size, entryBuffer))
+					failedCount++;
+			}
+			qint64 elapsed = timer.nsecsElapsed();
+			if(best < 0 || elapsed < best)
+				best = elapsed;
+		}
+
+		printf("  %-12s %9.1f ms %8.1f MB/s", backends.at(b)->name(), best / 1e6, perSecond(uncompressedBytes, best) / (1024 * 1024));
+		if(failedCount > 0)
+			printf("  %d entries failed", failedCount);
+		printf("\n");
+	}
+	return true;
+}
+
+// Bytes of the .class entries, read before anything is timed
+static bool readClassEntries(const QString &jarPath, QList<QByteArray> &classes)
+{
+	JarReader reader;
+	if(!reader.open(jarPath))
+	{
+		fprintf(stderr, "%s\n", reader.errorString().toLocal8Bit().constData());
+		return false;
+	}
+
+	for(int i = 0; i < reader.count(); i++)
+	{
+		if(reader.entry(i).name.endsWith(".class", Qt::CaseInsensitive))
+			classes.append(reader.read(i));
+	}
+	return true;
+}
+
+enum ParseMode
+{
+	PARSE_FULL,
+	PARSE_FULL_ARENA,
+	PARSE_SUMMARY,
+	PARSE_SUMMARY_ARENA
+};
+
+// With an arena, it's reset after each class as the loader workers do
+static void parseClasses(const QList<QByteArray> &classes, int mode, JClassArena *arena)
+{
+	bool full = (mode == PARSE_FULL || mode == PARSE_FULL_ARENA);
+	if(mode != PARSE_FULL_ARENA && mode != PARSE_SUMMARY_ARENA)
+		arena = NULL;
+
+	for(int i = 0; i < classes.size(); i++)
+	{
+		const char *data = classes.at(i).constData();
+		JavaClass *clazz = full ? jclass_class_new_from_buffer_in_arena(data, arena) : jclass_class_new_summary_from_buffer(data, NULL, arena);
+		if(arena != NULL)
+			jclass_arena_reset(arena);
+		else if(clazz != NULL)
+			jclass_class_free(clazz);
+	}
+}
+
+static bool benchParse(const QString &jarPath, int rounds)
+{
+	QList<QByteArray> classes;
+	if(!readClassEntries(jarPath, classes))
+		return false;
+
+	qint64 totalBytes = 0;
+	for(int i = 0; i < classes.size(); i++)
+		totalBytes += classes.at(i).size();
+	printf("parse %s : %d classes, %lld bytes per class\n", jarPath.toLocal8Bit().constData(),
+		classes.size(), classes.isEmpty() ? 0 : totalBytes / classes.size());
+	if(classes.isEmpty())
+		return true;
+
+	const char *modeNames[] = { "full, malloc", "full, arena", "summary, malloc", "summary, arena" };
+	JClassArena *arena = jclass_arena_new(64 * 1024);
+	if(arena == NULL)
+	{
+		fprintf(stderr, "%s\n", jclass_error_string(JCLASS_ERROR_MEMORY));
+		return false;
+	}
+	for(int mode = PARSE_FULL; mode <= PARSE_SUMMARY_ARENA; mode++)
+	{
+		qint64 best = -1;
+		for(int round = 0; round < rounds; round++)
+		{
+			QElapsedTimer timer;
+			timer.start();
+			parseClasses(classes, mode, arena);
+			qint64 elapsed = timer.nsecsElapsed();
+			if(best < 0 || elapsed < best)
+				best = elapsed;
+		}
+
+		// counted on a pass of their own, so the timed ones don't pay for it
+		allocationCount = 0;
+		allocatedBytes = 0;
+		countAllocations = true;
+		parseClasses(classes, mode, arena);
+		countAllocations = false;
+
+		printf("  %-16s %8.2f us/class", modeNames[mode], best / 1e3 / classes.size());
+#ifdef ALLOCATION_COUNTS
+		printf(" %8.1f mallocs/class %9.0f bytes/class", (double)allocationCount / classes.size(), (double)allocatedBytes / classes.size());
+#endif
+		printf("\n");
+	}
+	jclass_arena_free(arena);
+	return true;
+}
+
+// One analysis of the jar, as the command line analyzer runs it. The memory is the growth of the
+// process over the first round, from before the load and the mapping of the jar included : the
+// rounds after it reuse memory the allocator kept.
+static bool benchCollect(const QString &jarPath, int rounds)
+{
+	qint64 bestLoad = -1;
+	qint64 bestCollect = -1;
+	qint64 memoryBefore = processMemory();
+	qint64 memoryLoaded = 0;
+	qint64 memoryCollected = 0;
+	int classCount = 0;
+	int referenceCount = 0;
+	int symbolCount = 0;
+	qint64 symbolMemory = 0;
+	for(int round = 0; round < rounds; round++)
+	{
+		JarAnalyzer analyzer;
+
+		QElapsedTimer timer;
+		timer.start();
+		if(!analyzer.loadJarFile(jarPath))
+		{
+			fprintf(stderr, "%s\n", analyzer.errorString().toLocal8Bit().constData());
+			return false;
+		}
+		qint64 load = timer.nsecsElapsed();
+		if(round == 0)
+			memoryLoaded = processMemory();
+
+		timer.start();
+		if(!analyzer.collectData())
+		{
+			fprintf(stderr, "%s\n", analyzer.errorString().toLocal8Bit().constData());
+			return false;
+		}
+		qint64 collect = timer.nsecsElapsed();
+		if(round == 0)
+			memoryCollected = processMemory();
+
+		if(bestLoad < 0 || load < bestLoad)
+			bestLoad = load;
+		if(bestCollect < 0 || collect < bestCollect)
+			bestCollect = collect;
+
+		classCount = analyzer.classes().size();
+		referenceCount = analyzer.dependencyGraph().edgeCount();
+		symbolCount = analyzer.symbols().count();
+		symbolMemory = analyzer.symbols().memoryUsage();
+	}
+
+	printf("collect %s : %d classes, %d references\n", jarPath.toLocal8Bit().constData(), classCount, referenceCount);
+	printf("  load       %9.1f ms\n", bestLoad / 1e6);
+	printf("  collect    %9.1f ms\n", bestCollect / 1e6);
+	printf("  symbols    %9d names in %.1f MB\n", symbolCount, symbolMemory / (1024.0 * 1024));
+	if(memoryBefore > 0)
+	{
+		printf("  memory     %+9.1f MB after load, %+.1f MB after collect\n", (memoryLoaded - memoryBefore) / (1024.0 * 1024),
+			(memoryCollected - memoryBefore) / (1024.0 * 1024));
+	}
+	return true;
+}
+
+// The counting collectData() did before the inverted index : every class looked up in the
+// reference list of every other class. Only run up to this many classes.
+#define QUADRATIC_COUNT_LIMIT	20000
+
+static QVector<int> countReferencesQuadratic(const ClassTable &classes)
+{
+	QVector<int> referencedCounts(classes.size(), 0);
+	for(int row = 0; row < classes.size(); row++)
+	{
+		int classId = classes.classId(row);
+		for(int other = 0; other < classes.size(); other++)
+		{
+			const QVector<int> &referencedList = classes.referencedList(other);
+			if(qBinaryFind(referencedList, classId) != referencedList.end())
+				referencedCounts[row]++;
+		}
+	}
+	return referencedCounts;
+}
+
+static bool benchReferences(const QString &jarPath, int rounds)
+{
+	JarAnalyzer analyzer;
+	if(!analyzer.loadJarFile(jarPath) || !analyzer.collectData())
+	{
+		fprintf(stderr, "%s\n", analyzer.errorString().toLocal8Bit().constData());
+		return false;
+	}
+
+	const ClassTable &classes = analyzer.classes();
+	qint64 referenceCount = 0;
+	for(int row = 0; row < classes.size(); row++)
+		referenceCount += classes.referencedList(row).size();
+
+	qint64 best = -1;
+	QVector<int> referencedCounts;
+	for(int round = 0; round < rounds; round++)
+	{
+		QElapsedTimer timer;
+		timer.start();
+		referencedCounts = analyzer.countReferences();
+		qint64 elapsed = timer.nsecsElapsed();
+		if(best < 0 || elapsed < best)
+			best = elapsed;
+	}
+
+	printf("references %s : %d classes, %lld references\n", jarPath.toLocal8Bit().constData(), classes.size(), referenceCount);
+	printf("  inverted   %9.3f ms %8.2f ns/reference\n", best / 1e6, referenceCount > 0 ? (double)best / referenceCount : 0.0);
+
+	if(classes.size() > QUADRATIC_COUNT_LIMIT)
+		return true;
+
+	QElapsedTimer timer;
+	timer.start();
+	QVector<int> quadraticCounts = countReferencesQuadratic(classes);
+	qint64 elapsed = timer.nsecsElapsed();
+
+	int mismatchCount = 0;
+	for(int row = 0; row < classes.size(); row++)
+	{
+		if(quadraticCounts.at(row) != referencedCounts.at(classes.classId(row)))
+			mismatchCount++;
+	}
+	printf("  quadratic  %9.3f ms %8.2f ns/reference, %d counts differ\n", elapsed / 1e6,
+		referenceCount > 0 ? (double)elapsed / referenceCount : 0.0, mismatchCount);
+	return true;
+}
+
+// One heap item per class with its names as strings, laid out as ClassFileContext was before
+// ClassTable, the baseline of the table benchmark.
+struct ClassRowBaseline
+{
+	QString className;
+	QString filePath;
+	QString originalName;
+	QString fullClassNameForKey;
+	int classId;
+	int containerIndex;
+	int zipIndex;
+	quint32 crc;
+	long fileSize;
+	int methodCount;
+	int referencedCount;
+	bool javaFileFlag;
+	QVector<int> classReferencedList;
+	bool reachable;
+	long retainedSize;
+};
+
+// Qt 4 QString::Data and QVectorData headers on a 64 bit build
+enum { STRING_HEADER_SIZE = 24, VECTOR_HEADER_SIZE = 16 };
+
+static qint64 stringBytes(const QString &text)
+{
+	return STRING_HEADER_SIZE + (qint64)(text.size() + 1) * sizeof(QChar);
+}
+
+// The rows filled from the analyzed table, each reference list in its own block
+static qint64 buildBaselineRows(const JarAnalyzer &analyzer, QList<ClassRowBaseline*> &rows)
+{
+	const ClassTable &classes = analyzer.classes();
+	qint64 bytes = (qint64)classes.size() * sizeof(void*);
+	for(int row = 0; row < classes.size(); row++)
+	{
+		ClassRowBaseline *item = new ClassRowBaseline;
+		item->className = analyzer.className(row);
+		item->filePath = analyzer.filePath(row);
+		item->originalName = analyzer.originalName(row);
+		item->fullClassNameForKey = analyzer.fullClassNameForKey(row);
+		item->classId = classes.classId(row);
+		item->containerIndex = classes.containerIndex(row);
+		item->zipIndex = classes.zipIndex(row);
+		item->crc = classes.crc(row);
+		item->fileSize = classes.fileSize(row);
+		item->methodCount = classes.methodCount(row);
+		item->referencedCount = classes.referencedCount(row);
+		item->javaFileFlag = classes.javaFileFlag(row);
+		const QVector<int> &references = classes.referencedList(row);
+		item->classReferencedList.reserve(references.size());
+		for(int i = 0; i < references.size(); i++)
+			item->classReferencedList.append(references.at(i));
+		item->reachable = classes.isReachable(row);
+		item->retainedSize = classes.retainedSize(row);
+		rows.append(item);
+
+		bytes += sizeof(ClassRowBaseline) + stringBytes(item->className) + stringBytes(item->filePath)
+			+ stringBytes(item->originalName) + stringBytes(item->fullClassNameForKey);
+		if(!references.isEmpty())
+			bytes += VECTOR_HEADER_SIZE + (qint64)references.size() * sizeof(int);
+	}
+	return bytes;
+}
+
+static bool benchTable(const QString &jarPath, int rounds)
+{
+	qint64 memoryBefore = processMemory();
+	JarAnalyzer analyzer;
+	if(!analyzer.loadJarFile(jarPath) || !analyzer.collectData())
+	{
+		fprintf(stderr, "%s\n", analyzer.errorString().toLocal8Bit().constData());
+		return false;
+	}
+	qint64 memoryCollected = processMemory();
+
+	const ClassTable &classes = analyzer.classes();
+	printf("table %s : %d classes\n", jarPath.toLocal8Bit().constData(), classes.size());
+	printf("  class table %8.1f MB, symbols %.1f MB", classes.memoryUsage() / (1024.0 * 1024),
+		analyzer.symbols().memoryUsage() / (1024.0 * 1024));
+	if(memoryBefore > 0)
+		printf(", process %+.1f MB after collect", (memoryCollected - memoryBefore) / (1024.0 * 1024));
+	printf("\n");
+
+	// the same rows as one heap item each with four strings, kept until the scans are done
+	QList<ClassRowBaseline*> baselineRows;
+	qint64 rowBytes = buildBaselineRows(analyzer, baselineRows);
+	qint64 memoryRows = processMemory();
+	qint64 columnBytes = classes.memoryUsage() + analyzer.symbols().memoryUsage();
+	printf("  footprint   %8.1f MB columns and symbols, %.1f MB rows of structs, columns at %.0f%%", columnBytes / (1024.0 * 1024),
+		rowBytes / (1024.0 * 1024), rowBytes > 0 ? columnBytes * 100.0 / rowBytes : 0.0);
+	if(memoryBefore > 0)
+		printf(", process %+.1f MB for the rows", (memoryRows - memoryCollected) / (1024.0 * 1024));
+	printf("\n");
+
+	SearchFilter outerClasses;
+	outerClasses.ignoreInnerClass = true;
+	SearchFilter anonymousClasses;
+	anonymousClasses.onlyAnonymousClass = true;
+	const SearchFilter *filters[] = { &outerClasses, &anonymousClasses };
+	const char *filterNames[] = { "outer search", "anonymous search" };
+	for(int f = 0; f < 2; f++)
+	{
+		qint64 best = -1;
+		int rowCount = 0;
+		for(int round = 0; round < rounds; round++)
+		{
+			QElapsedTimer timer;
+			timer.start();
+			rowCount = analyzer.search(*filters[f]).size();
+			qint64 elapsed = timer.nsecsElapsed();
+			if(best < 0 || elapsed < best)
+				best = elapsed;
+		}
+		printf("  %-17s %8.3f ms %8d rows\n", filterNames[f], best / 1e6, rowCount);
+	}
+
+	// size of the classes nothing references : two columns read from start to end
+	qint64 best = -1;
+	qint64 unreferencedSize = 0;
+	for(int round = 0; round < rounds; round++)
+	{
+		QElapsedTimer timer;
+		timer.start();
+		unreferencedSize = 0;
+		for(int row = 0; row < classes.size(); row++)
+		{
+			if(classes.referencedCount(row) == 0)
+				unreferencedSize += classes.fileSize(row);
+		}
+		qint64 elapsed = timer.nsecsElapsed();
+		if(best < 0 || elapsed < best)
+			best = elapsed;
+	}
+	qint64 scannedBytes = (qint64)classes.size() * (sizeof(int) + sizeof(long));
+	printf("  %-17s %8.3f ms %8.1f GB/s, %lld bytes unreferenced\n", "column scan", best / 1e6,
+		perSecond(scannedBytes, best) / (1024.0 * 1024 * 1024), unreferencedSize);
+
+	// the same two fields read through the row pointers
+	best = -1;
+	for(int round = 0; round < rounds; round++)
+	{
+		QElapsedTimer timer;
+		timer.start();
+		unreferencedSize = 0;
+		for(int row = 0; row < baselineRows.size(); row++)
+		{
+			const ClassRowBaseline *item = baselineRows.at(row);
+			if(item->referencedCount == 0)
+				unreferencedSize += item->fileSize;
+		}
+		qint64 elapsed = timer.nsecsElapsed();
+		if(best < 0 || elapsed < best)
+			best = elapsed;
+	}
+	printf("  %-17s %8.3f ms %8.1f GB/s, %lld bytes unreferenced\n", "row scan", best / 1e6,
+		perSecond(scannedBytes, best) / (1024.0 * 1024 * 1024), unreferencedSize);
+
+	qDeleteAll(baselineRows);
+	return true;
+}
+
+// Every entry read and kept the way each class held its bytes before the entry cache, then read
+// once more through JarAnalyzer::entryBytes() as a text search does. The kept bytes stay alive
+// so the cache pass cannot reuse their memory, and while reading through the cache the process
+// may only grow by the cache budget and the pages of the jar mapping.
+static bool benchCache(const QString &jarPath, int cacheMB)
+{
+	JarAnalyzer analyzer;
+	// no entry fits, every read goes to the jar
+	analyzer.setEntryCacheSize(1);
+	if(!analyzer.loadJarFile(jarPath) || !analyzer.collectData())
+	{
+		fprintf(stderr, "%s\n", analyzer.errorString().toLocal8Bit().constData());
+		return false;
+	}
+
+	const ClassTable &classes = analyzer.classes();
+	qint64 uncompressedSize = 0;
+	for(int row = 0; row < classes.size(); row++)
+		uncompressedSize += classes.fileSize(row);
+	qint64 jarSize = QFileInfo(jarPath).size();
+
+	qint64 memoryCollected = processMemory();
+	QVector<QByteArray> keptBytes;
+	keptBytes.reserve(classes.size());
+	qint64 keptSize = 0;
+	QElapsedTimer timer;
+	timer.start();
+	for(int row = 0; row < classes.size(); row++)
+	{
+		keptBytes.append(analyzer.entryBytes(row));
+		keptSize += keptBytes.last().size();
+	}
+	qint64 keptTime = timer.nsecsElapsed();
+	qint64 memoryKept = processMemory();
+
+	// sampled every 64 entries, the cache evicts as it goes
+	analyzer.setEntryCacheSize(cacheMB * 1024 * 1024);
+	qint64 peakCached = memoryKept;
+	timer.start();
+	for(int row = 0; row < classes.size(); row++)
+	{
+		QByteArray bytes = analyzer.entryBytes(row);
+		if((row & 63) == 0)
+			peakCached = qMax(peakCached, processMemory());
+	}
+	peakCached = qMax(peakCached, processMemory());
+	qint64 cachedTime = timer.nsecsElapsed();
+	qint64 cacheUsed = analyzer.entryCacheUsed();
+
+	int count = qMax(classes.size(), 1);
+	printf("cache %s : %d entries, %.1f MB uncompressed, %.1f MB jar, %d MB cache\n", jarPath.toLocal8Bit().constData(),
+		classes.size(), uncompressedSize / (1024.0 * 1024), jarSize / (1024.0 * 1024), cacheMB);
+	printf("  keep all   %9.1f ms %8.0f bytes retained per class", keptTime / 1e6, (double)keptSize / count);
+	if(memoryCollected > 0)
+		printf(", %+.1f MB", (memoryKept - memoryCollected) / (1024.0 * 1024));
+	printf("\n");
+	printf("  cache      %9.1f ms %8.0f bytes retained per class", cachedTime / 1e6, (double)cacheUsed / count);
+	if(memoryCollected > 0)
+		printf(", peak %+.1f MB", (peakCached - memoryKept) / (1024.0 * 1024));
+	printf("\n");
+
+	if(memoryCollected <= 0)
+		return true;
+	qint64 bound = (qint64)cacheMB * 1024 * 1024 + jarSize;
+	bool within = (peakCached - memoryKept <= bound);
+	printf("  cache peak %s the cache budget and the jar mapping (%.1f MB), the uncompressed entries and the budget are %.1f MB\n",
+		within ? "within" : "OVER", bound / (1024.0 * 1024), (uncompressedSize + (qint64)cacheMB * 1024 * 1024) / (1024.0 * 1024));
+	return within;
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+#if defined(_MSC_VER) && defined(_DEBUG)
+	_CrtSetAllocHook(allocHook);
+#endif
+
+	QStringList args = a.arguments();
+	QString benchmark;
+	QStringList jarPaths;
+	int rounds = 3;
+	int maxThreads = QThread::idealThreadCount();
+	int cacheMB = 32;
+
+	for(int i = 1; i < args.size(); i++)
+	{
+		const QString &arg = args.at(i);
+		bool hasValue = i + 1 < args.size();
+
+		if(arg == "--rounds" && hasValue)
+			rounds = args.at(++i).toInt();
+		else if(arg == "--threads" && hasValue)
+			maxThreads = args.at(++i).toInt();
+		else if(arg == "--cache-mb" && hasValue)
+			cacheMB = args.at(++i).toInt();
+		else if(!arg.startsWith("--") && benchmark.isEmpty())
+			benchmark = arg;
+		else if(!arg.startsWith("--"))
+			jarPaths.append(arg);
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	if(jarPaths.isEmpty() || rounds < 1 || maxThreads < 1 || cacheMB < 1)
+	{
+		printUsage();
+		return 1;
+	}
+
+	for(int i = 0; i < jarPaths.size(); i++)
+	{
+		bool ok;
+		if(benchmark == "ingest")
+			ok = benchIngest(jarPaths.at(i), rounds);
+		else if(benchmark == "load")
+			ok = benchLoad(jarPaths.at(i), rounds, maxThreads);
+		else if(benchmark == "inflate")
+			ok = benchInflate(jarPaths.at(i), rounds);
+		else if(benchmark == "parse")
+			ok = benchParse(jarPaths.at(i), rounds);
+		else if(benchmark == "collect")
+			ok = benchCollect(jarPaths.at(i), rounds);
+		else if(benchmark == "references")
+			ok = benchReferences(jarPaths.at(i), rounds);
+		else if(benchmark == "table")
+			ok = benchTable(jarPaths.at(i), rounds);
+		else if(benchmark == "cache")
+			ok = benchCache(jarPaths.at(i), cacheMB);
+		else
+		{
+			printUsage();
+			return 1;
+		}
+		if(!ok)
+			return 2;
+	}
+	return 0;
+}
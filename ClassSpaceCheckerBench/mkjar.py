@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+# Writes a jar of generated classes for ClassSpaceCheckerBench, the same jar for the same arguments.
+#
+#   mkjar.py [--real] out.jar count
+#
+# Without --real the classes are small (2 to 5 methods, 3 references each) and every fifth
+# one has an anonymous inner class, like the 1k/10k/100k jars of the reference counting
+# and class table benchmarks. --real gives about 5.5 KB classes with fields, Code,
+# LineNumberTable and LocalVariableTable attributes, for the parse benchmarks.
+
+import random
+import struct
+import sys
+import zipfile
+
+
+def u2(value):
+    return struct.pack('>H', value)
+
+
+def u4(value):
+    return struct.pack('>I', value)
+
+
+class ConstantPool(object):
+    def __init__(self):
+        self.entries = []
+
+    def utf8(self, text):
+        data = text.encode()
+        self.entries.append(b'\x01' + u2(len(data)) + data)
+        return len(self.entries)
+
+    def class_ref(self, name):
+        index = self.utf8(name)
+        self.entries.append(b'\x07' + u2(index))
+        return len(self.entries)
+
+    def bytes(self):
+        return u2(len(self.entries) + 1) + b''.join(self.entries)
+
+
+def small_class(name, refs, method_count=2):
+    cp = ConstantPool()
+    this = cp.class_ref(name)
+    super_class = cp.class_ref('java/lang/Object')
+    for ref in refs:
+        cp.class_ref(ref)
+    method_name = cp.utf8('m')
+    method_desc = cp.utf8('()V')
+    code_name = cp.utf8('Code')
+
+    out = u4(0xCAFEBABE) + u2(0) + u2(50) + cp.bytes()
+    out += u2(0x21) + u2(this) + u2(super_class) + u2(0) + u2(0)
+    out += u2(method_count)
+    for i in range(method_count):
+        code = b'\xb1'  # return
+        attr = u2(1) + u2(1) + u4(len(code)) + code + u2(0) + u2(0)
+        out += u2(1) + u2(method_name) + u2(method_desc) + u2(1) + u2(code_name) + u4(len(attr)) + attr
+    out += u2(0)
+    return out
+
+
+def real_class(name, refs, field_count, method_count, code_length):
+    cp = ConstantPool()
+    this = cp.class_ref(name)
+    super_class = cp.class_ref('java/lang/Object')
+    for ref in refs:
+        cp.class_ref(ref)
+    names = [cp.utf8('f%d' % i) for i in range(max(field_count, method_count))]
+    field_desc = cp.utf8('Ljava/lang/String;')
+    method_desc = cp.utf8('(ILjava/lang/String;)V')
+    code_name = cp.utf8('Code')
+    line_table = cp.utf8('LineNumberTable')
+    local_table = cp.utf8('LocalVariableTable')
+    signature = cp.utf8('Signature')
+    source_file = cp.utf8('SourceFile')
+    source_name = cp.utf8(name.split('/')[-1] + '.java')
+
+    out = u4(0xCAFEBABE) + u2(0) + u2(52) + cp.bytes()
+    out += u2(0x21) + u2(this) + u2(super_class) + u2(0)
+    out += u2(field_count)
+    for i in range(field_count):
+        out += u2(2) + u2(names[i]) + u2(field_desc) + u2(1) + u2(signature) + u4(2) + u2(field_desc)
+    out += u2(method_count)
+    for i in range(method_count):
+        code = bytes(random.randrange(256) for _ in range(code_length))
+        lines = u2(code_length // 4) + b''.join(u2(k) + u2(k) for k in range(code_length // 4))
+        locals_ = u2(3) + b''.join(u2(0) + u2(code_length) + u2(names[k]) + u2(field_desc) + u2(k) for k in range(3))
+        sub = u2(line_table) + u4(len(lines)) + lines + u2(local_table) + u4(len(locals_)) + locals_
+        attr = u2(4) + u2(5) + u4(len(code)) + code + u2(0) + u2(2) + sub
+        out += u2(1) + u2(names[i]) + u2(method_desc) + u2(1) + u2(code_name) + u4(len(attr)) + attr
+    out += u2(1) + u2(source_file) + u4(2) + u2(source_name)
+    return out
+
+
+def write_small_jar(path, count):
+    random.seed(1)
+    names = ['com/ex/p%d/C%d' % (i % 7, i) for i in range(count)]
+    with zipfile.ZipFile(path, 'w') as jar:
+        jar.writestr('META-INF/MANIFEST.MF', 'Manifest-Version: 1.0\nMain-Class: com.ex.p0.C0\n')
+        for i, name in enumerate(names):
+            refs = [ref for ref in random.sample(names, min(3, count)) if ref != name]
+            if i % 5 == 0:
+                inner = name + '$1'
+                jar.writestr(inner + '.class', small_class(inner, [name]), compress_type=zipfile.ZIP_DEFLATED)
+            method = zipfile.ZIP_DEFLATED if i % 3 else zipfile.ZIP_STORED
+            jar.writestr(name + '.class', small_class(name, refs, i % 4 + 1), compress_type=method)
+        jar.writestr('com/ex/Readme.java', 'class Readme {}')
+
+
+def write_real_jar(path, count):
+    random.seed(3)
+    names = ['com/real/p%d/C%d' % (i % 20, i) for i in range(count)]
+    with zipfile.ZipFile(path, 'w') as jar:
+        for name in names:
+            data = real_class(name, random.sample(names, min(8, count)), random.randint(2, 12),
+                random.randint(4, 30), random.randint(20, 200))
+            jar.writestr(name + '.class', data, compress_type=zipfile.ZIP_DEFLATED)
+
+
+if __name__ == '__main__':
+    args = sys.argv[1:]
+    real = '--real' in args
+    if real:
+        args.remove('--real')
+    if len(args) != 2:
+        sys.exit('usage: mkjar.py [--real] out.jar count')
+    if real:
+        write_real_jar(args[0], int(args[1]))
+    else:
+        write_small_jar(args[0], int(args[1]))
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+# Writes the zip64 jars JarReader has to list in full, with more than 65535 entries.
+#
+#   mkzip64.py out_prefix [count]
+#
+# out_prefix.jar          zip64 end of central directory record and locator
+# out_prefix_stub.jar     the same behind a shell stub, so the recorded offsets are off by its size
+# out_prefix_wrapped.jar  classic end record only, the entry count wrapped to 16 bits
+# out_prefix_extra.jar    sizes and offsets of the central directory saturated to 0xffffffff,
+#                         the real values in zip64 extra fields
+#
+# Each one must give count classes (70000 by default), e.g. with
+#   ClassSpaceCheckerBench load out_prefix.jar out_prefix_stub.jar ...
+
+import os
+import struct
+import sys
+import zipfile
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from mkjar import small_class
+
+CENTRAL_HEADER = b'PK\x01\x02'
+END_RECORD = b'PK\x05\x06'
+ZIP64_END_RECORD = b'PK\x06\x06'
+ZIP64_LOCATOR = b'PK\x06\x07'
+
+
+def end_records(data):
+    zip64_end = data.rfind(ZIP64_END_RECORD)
+    cd_size, cd_offset = struct.unpack('<QQ', data[zip64_end + 40:zip64_end + 56])
+    return zip64_end, cd_size, cd_offset
+
+
+def zip64_end(entry_count, cd_size, cd_offset):
+    record = ZIP64_END_RECORD + struct.pack('<QHHIIQQQQ', 44, 45, 45, 0, 0, entry_count, entry_count, cd_size, cd_offset)
+    locator = ZIP64_LOCATOR + struct.pack('<IQI', 0, cd_offset + cd_size, 1)
+    end = END_RECORD + struct.pack('<HHHHIIH', 0, 0, 0xffff, 0xffff, 0xffffffff, 0xffffffff, 0)
+    return record + locator + end
+
+
+def wrapped(data, count):
+    zip64_record, cd_size, cd_offset = end_records(data)
+    end = END_RECORD + struct.pack('<HHHHIIH', 0, 0, count % 65536, count % 65536, cd_size, cd_offset, 0)
+    return data[:zip64_record] + end
+
+
+def with_extra_fields(data, count):
+    zip64_record, cd_size, cd_offset = end_records(data)
+    central = data[cd_offset:cd_offset + cd_size]
+    records = []
+    pos = 0
+    while central[pos:pos + 4] == CENTRAL_HEADER:
+        name_length, extra_length, comment_length = struct.unpack('<HHH', central[pos + 28:pos + 34])
+        compressed, uncompressed = struct.unpack('<II', central[pos + 20:pos + 28])
+        local_offset = struct.unpack('<I', central[pos + 42:pos + 46])[0]
+        header = bytearray(central[pos:pos + 46])
+        struct.pack_into('<II', header, 20, 0xffffffff, 0xffffffff)
+        struct.pack_into('<H', header, 30, extra_length + 28)
+        struct.pack_into('<I', header, 42, 0xffffffff)
+        name = central[pos + 46:pos + 46 + name_length]
+        extra = central[pos + 46 + name_length:pos + 46 + name_length + extra_length]
+        comment = central[pos + 46 + name_length + extra_length:pos + 46 + name_length + extra_length + comment_length]
+        zip64_extra = struct.pack('<HHQQQ', 1, 24, uncompressed, compressed, local_offset)
+        records.append(bytes(header) + name + extra + zip64_extra + comment)
+        pos += 46 + name_length + extra_length + comment_length
+    central = b''.join(records)
+    return data[:cd_offset] + central + zip64_end(count, len(central), cd_offset)
+
+
+if __name__ == '__main__':
+    if len(sys.argv) not in (2, 3):
+        sys.exit('usage: mkzip64.py out_prefix [count]')
+    prefix = sys.argv[1]
+    count = int(sys.argv[2]) if len(sys.argv) == 3 else 70000
+    if count <= 65535:
+        sys.exit('count must be over 65535 for a zip64 jar')
+
+    with zipfile.ZipFile(prefix + '.jar', 'w') as jar:
+        for i in range(count):
+            name = 'com/z/p%d/C%d' % (i % 50, i)
+            method = zipfile.ZIP_DEFLATED if i % 2 else zipfile.ZIP_STORED
+            jar.writestr(name + '.class', small_class(name, ['com/z/p0/C0']), compress_type=method)
+
+    with open(prefix + '.jar', 'rb') as jar:
+        data = jar.read()
+    with open(prefix + '_stub.jar', 'wb') as jar:
+        jar.write(b'#!/bin/sh\nexec java -jar "$0" "$@"\n' + data)
+    with open(prefix + '_wrapped.jar', 'wb') as jar:
+        jar.write(wrapped(data, count))
+    with open(prefix + '_extra.jar', 'wb') as jar:
+        jar.write(with_extra_fields(data, count))
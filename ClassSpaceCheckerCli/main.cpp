@@ -0,0 +1,298 @@
+#include <QtCore>
+#include <stdio.h>
+#include "JarAnalyzer.h"
+
+// Headless version of the main window : loads a jar (and its proguard map), runs the same
+// analysis and writes the File, Package, Inner Class and Dependencies reports as csv or json files.
+
+struct Report
+{
+	QStringList header;
+	QList<QVariantList> rows;
+};
+
+static void printUsage()
+{
+	fprintf(stderr,
+		"Usage: ClassSpaceCheckerCli [options] <jar file>\n"
+		"  --map <file>         proguard map file\n"
+		"  --search <regexp>    search class name (uncrypted name when a map is given)\n"
+		"  --search-text <text> search text\n"
+		"  --ignore-inner       ignore inner classes\n"
+		"  --only-anonymous     only anonymous classes\n"
+		"  --package            use the search as a package name\n"
+		"  --root <regexp>      classes matching the whole pattern are reachability roots, repeatable\n"
+		"  --keep <file>        class names used as reachability roots, one per line\n"
+		"  --no-main-class      don't use the manifest Main-Class as a reachability root\n"
+		"  --format <csv|json>  output format (default csv)\n"
+		"  --cache-mb <n>       memory kept for class bytes read by --search-text (default 32)\n"
+		"  --out <prefix>       output file prefix (default jar file name)\n");
+}
+
+static Report fileReport(const JarAnalyzer &analyzer, const SearchFilter &filter)
+{
+	Report report;
+	report.header = QString("Class Name;File Size;Uncrypted Name;Method Count;Referenced Count;Container;Parse Error;Reachable;Retained Size").split(";");
+
+	const ClassTable &classes = analyzer.classes();
+	QVector<int> rows = analyzer.search(filter);
+	QVector<int>::iterator it = rows.begin();
+	for(; it != rows.end(); it++)
+	{
+		int classRow = *it;
+		QVariantList row;
+		row << analyzer.className(classRow) << classes.fileSize(classRow);
+		row << (analyzer.mapPath().isEmpty() ? QString("-") : analyzer.originalName(classRow));
+		row << classes.methodCount(classRow) << classes.referencedCount(classRow);
+		row << analyzer.containerPath(classRow) << classes.parseError(classRow);
+		row << QString(classes.isReachable(classRow) ? "Yes" : "No") << classes.retainedSize(classRow);
+		report.rows.append(row);
+	}
+	return report;
+}
+
+static Report packageReport(const JarAnalyzer &analyzer)
+{
+	Report report;
+	report.header = QString("Package Name;All Class Count;Unique Count;Anonymous Count;Diff Count;File Size;Unreachable Count;Unreachable Size;Retained Size").split(";");
+
+	QList<const PackageContext*> rows = analyzer.packageReport();
+	QList<const PackageContext*>::iterator it = rows.begin();
+	for(; it != rows.end(); it++)
+	{
+		const PackageContext* ctx = *it;
+		QVariantList row;
+		row << ctx->packageName << ctx->classCount << ctx->uniqueClassNameSet.size() << ctx->anonymousClassCount;
+		row << (ctx->classCount - ctx->uniqueClassNameSet.size()) << ctx->fileSize;
+		row << ctx->unreachableClassCount << ctx->unreachableFileSize << ctx->retainedSize;
+		report.rows.append(row);
+	}
+	return report;
+}
+
+static Report innerClassReport(const JarAnalyzer &analyzer)
+{
+	Report report;
+	report.header = QString("Class Name;Inner Count;Anonymous Count;File Size").split(";");
+
+	QList<const UniqueClassContext*> rows = analyzer.innerClassReport();
+	QList<const UniqueClassContext*>::iterator it = rows.begin();
+	for(; it != rows.end(); it++)
+	{
+		const UniqueClassContext* ctx = *it;
+		QVariantList row;
+		row << ctx->uniqueClassName << (ctx->classCount - 1) << ctx->anonymousCount << ctx->fileSize;
+		report.rows.append(row);
+	}
+	return report;
+}
+
+// one row per class of the jar, the members of a reference cycle share its number
+static Report dependencyReport(const JarAnalyzer &analyzer)
+{
+	Report report;
+	report.header = QString("Class Name;Uncrypted Name;Fan In;Fan Out;Cycle;Cycle Size").split(";");
+
+	const DependencyGraph &graph = analyzer.dependencyGraph();
+	for(int node = 0; node < graph.nodeCount(); node++)
+	{
+		int classRow = graph.rowAt(node);
+		int component = graph.component(node);
+		int cycleSize = graph.componentSize(component);
+
+		QVariantList row;
+		row << analyzer.className(classRow) << (analyzer.mapPath().isEmpty() ? QString("-") : analyzer.originalName(classRow));
+		row << graph.inDegree(node) << graph.outDegree(node);
+		row << (cycleSize > 1 ? component + 1 : 0) << (cycleSize > 1 ? cycleSize : 0);
+		report.rows.append(row);
+	}
+	return report;
+}
+
+static QString quoteCSV(const QString &text)
+{
+	QString result = text;
+	result.replace("\"", "\"\"");
+	return "\"" + result + "\"";
+}
+
+static QString quoteJSON(const QString &text)
+{
+	QString result;
+	for(int i = 0; i < text.length(); i++)
+	{
+		QChar c = text.at(i);
+		if(c == '"' || c == '\\')
+			result += QString("\\") + c;
+		else if(c.unicode() < 0x20)
+			result += QString("\\u%1").arg((int)c.unicode(), 4, 16, QChar('0'));
+		else
+			result += c;
+	}
+	return "\"" + result + "\"";
+}
+
+static bool writeReport(const Report &report, const QString &outputPath, bool json)
+{
+	QFile outputFile(outputPath);
+	if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+	{
+		fprintf(stderr, "Failed to create %s\n", outputPath.toLocal8Bit().constData());
+		return false;
+	}
+
+	QTextStream out(&outputFile);
+	out.setCodec("UTF-8");
+
+	if(json)
+	{
+		out << "[\n";
+		for(int i = 0; i < report.rows.size(); i++)
+		{
+			const QVariantList &row = report.rows.at(i);
+			out << "  {";
+			for(int j = 0; j < row.size(); j++)
+			{
+				if(j != 0)
+					out << ", ";
+				out << quoteJSON(report.header.at(j)) << ": ";
+				if(row.at(j).type() == QVariant::String)
+					out << quoteJSON(row.at(j).toString());
+				else
+					out << row.at(j).toString();
+			}
+			out << (i + 1 < report.rows.size() ? "},\n" : "}\n");
+		}
+		out << "]\n";
+	}
+	else
+	{
+		for(int i = 0; i < report.header.size(); i++) 
+		{
+			if(i != 0)
+				out << ",";
+			out << quoteCSV(report.header.at(i));
+		}
+		out << "\n";
+
+		for(int i = 0; i < report.rows.size(); i++)
+		{
+			const QVariantList &row = report.rows.at(i);
+			for(int j = 0; j < row.size(); j++)
+			{
+				if(j != 0)
+					out << ",";
+				out << quoteCSV(row.at(j).toString());
+			}
+			out << "\n";
+		}
+	}
+
+	out.flush();
+	outputFile.close();
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	QStringList args = a.arguments();
+	QString jarPath;
+	QString mapPath;
+	QString outputPrefix;
+	QString format = "csv";
+	int cacheMB = 0;
+	SearchFilter filter;
+	ReachabilityRoots roots;
+	QString keepPath;
+
+	for(int i = 1; i < args.size(); i++)
+	{
+		const QString &arg = args.at(i);
+		bool hasValue = i + 1 < args.size();
+
+		if(arg == "--map" && hasValue)
+			mapPath = args.at(++i);
+		else if(arg == "--search" && hasValue)
+			filter.searchName = args.at(++i);
+		else if(arg == "--search-text" && hasValue)
+			filter.searchText = args.at(++i);
+		else if(arg == "--format" && hasValue)
+			format = args.at(++i);
+		else if(arg == "--out" && hasValue)
+			outputPrefix = args.at(++i);
+		else if(arg == "--cache-mb" && hasValue)
+			cacheMB = args.at(++i).toInt();
+		else if(arg == "--ignore-inner")
+			filter.ignoreInnerClass = true;
+		else if(arg == "--only-anonymous")
+			filter.onlyAnonymousClass = true;
+		else if(arg == "--package")
+			filter.useAsPackageName = true;
+		else if(arg == "--root" && hasValue)
+			roots.namePatterns.append(args.at(++i));
+		else if(arg == "--keep" && hasValue)
+			keepPath = args.at(++i);
+		else if(arg == "--no-main-class")
+			roots.useMainClass = false;
+		else if(!arg.startsWith("--") && jarPath.isEmpty())
+			jarPath = arg;
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	if(jarPath.isEmpty() || (format != "csv" && format != "json"))
+	{
+		printUsage();
+		return 1;
+	}
+
+	if(outputPrefix.isEmpty())
+		outputPrefix = QFileInfo(jarPath).completeBaseName();
+
+	// like the main window, the uncrypted names are searched by default once a map is given
+	JarAnalyzer analyzer;
+	if(cacheMB > 0)
+		analyzer.setEntryCacheSize(cacheMB * 1024 * 1024);
+	if(mapPath.isEmpty() == false)
+	{
+		if(!analyzer.loadMapFile(mapPath))
+		{
+			fprintf(stderr, "%s\n", analyzer.errorString().toLocal8Bit().constData());
+			return 2;
+		}
+		filter.useUncryptName = true;
+	}
+
+	analyzer.setReachabilityRoots(roots);
+	if(!keepPath.isEmpty() && !analyzer.loadKeepFile(keepPath))
+	{
+		fprintf(stderr, "%s\n", analyzer.errorString().toLocal8Bit().constData());
+		return 2;
+	}
+
+	if(!analyzer.loadJarFile(jarPath))
+	{
+		fprintf(stderr, "%s\n", analyzer.errorString().toLocal8Bit().constData());
+		return 2;
+	}
+	if(!analyzer.collectData())
+	{
+		fprintf(stderr, "%s\n", analyzer.errorString().toLocal8Bit().constData());
+		return 2;
+	}
+
+	bool json = (format == "json");
+	QString suffix = json ? ".json" : ".csv";
+
+	bool ok = writeReport(fileReport(analyzer, filter), outputPrefix + "_classes" + suffix, json);
+	ok = writeReport(packageReport(analyzer), outputPrefix + "_packages" + suffix, json) && ok;
+	ok = writeReport(innerClassReport(analyzer), outputPrefix + "_innerclasses" + suffix, json) && ok;
+	ok = writeReport(dependencyReport(analyzer), outputPrefix + "_dependencies" + suffix, json) && ok;
+
+	return ok ? 0 : 3;
+}
@@ -0,0 +1,518 @@
+#include <QtCore>
+#include <stdio.h>
+#if defined(Q_OS_WIN)
+#include <qt_windows.h>
+#include "XZip/XUnzip.h"
+#endif
+#include "XZip/JarReader.h"
+#include "jclass/jclass.h"
+#include "ClassTable.h"
+#include "DependencyGraph.h"
+#include "JarLoader.h"
+#include "SymbolTable.h"
+
+// Regression tests of the analysis, run from the solution directory or given the fixtures
+// directory (ClassSpaceCheckerTest/fixtures, written by mkfixtures.py).
+// Prints each failed check and exits with 1 if any.
+
+static int failureCount = 0;
+
+static void check(bool condition, const char *expression, const char *file, int line)
+{
+	if(condition)
+		return;
+	fprintf(stderr, "%s(%d) : failed %s\n", file, line, expression);
+	failureCount++;
+}
+
+static void checkEqual(const QString &actual, const QString &expected, const char *file, int line)
+{
+	if(actual == expected)
+		return;
+	fprintf(stderr, "%s(%d) : got      %s\n%s(%d) : expected %s\n", file, line, actual.toLocal8Bit().constData(),
+		file, line, expected.toLocal8Bit().constData());
+	failureCount++;
+}
+
+#define CHECK(condition) check((condition), #condition, __FILE__, __LINE__)
+#define CHECK_EQUAL(actual, expected) checkEqual((actual), (expected), __FILE__, __LINE__)
+
+// "name;file size;method count;referenced classes", the names as the reports show them
+static QString classRow(const QString &className, long fileSize, int methodCount, QStringList referencedList)
+{
+	referencedList.sort();
+	return QString("%1;%2;%3;%4").arg(className).arg(fileSize).arg(methodCount).arg(referencedList.join(" "));
+}
+
+// The row of an entry as the main window read it before JarLoader : unzipped to a temp file and
+// parsed from there by jclass_class_new(), the CONSTANT_Class names taken as they come out of
+// jclass_cp_get_class_name(), primitive types and the class itself left out. That loader set the
+// method count back to 0 after the parse, the count the parse read is kept here.
+static QString tempFileRow(const QString &fileName, long fileSize, const QString &tempPath)
+{
+	bool javaFileFlag = fileName.endsWith(".java", Qt::CaseInsensitive);
+	QString className = fileName.left(fileName.lastIndexOf('.'));
+	className.replace("/", ".");
+	if(javaFileFlag)
+		return classRow(className, fileSize, -1, QStringList());
+
+	JavaClass *clazz = jclass_class_new(QFile::encodeName(tempPath).constData(), NULL);
+	if(clazz == NULL || clazz->constant_pool == NULL)
+		return classRow(className, fileSize, 0, QStringList());
+
+	ConstantPool *constant_pool = clazz->constant_pool;
+	char* this_class = jclass_cp_get_this_class_name(constant_pool);
+	QSet<QString> referencedSet;
+	for(int count = 1; count < constant_pool->count; count++)
+	{
+		if(constant_pool->entries[count].tag != CONSTANT_Class)
+			continue;
+
+		char* class_name = jclass_cp_get_class_name(constant_pool, count, 1);
+		if(!jclass_string_is_primitive_type(class_name) && strcmp(class_name, this_class) != 0)
+			referencedSet.insert(QString::fromUtf8(class_name));
+		free(class_name);
+	}
+	QString row = classRow(className, fileSize, clazz->methods_count, referencedSet.toList());
+
+	free(this_class);
+	jclass_class_free(clazz);
+	return row;
+}
+
+static bool isClassEntry(const QString &fileName)
+{
+	return fileName.endsWith(".class", Qt::CaseInsensitive) || fileName.endsWith(".java", Qt::CaseInsensitive);
+}
+
+// Writes the rows of the .class and .java entries of jarPath the way the loader before JarLoader
+// read them : through XUnzip on Windows, as that loader did, elsewhere through JarReader.
+static bool writeLoaderExpected(const QString &jarPath, const QString &outputPath)
+{
+	// jclass_class_new() only takes a path ending with .class as a file
+	QStringList rows;
+	QString tempBase = QDir::tempPath() + "/ClassSpaceCheckerTest";
+#if defined(Q_OS_WIN)
+	HZIP hz = OpenZip( (void *)jarPath.toStdWString().c_str(), 0, ZIP_FILENAME );
+	if( !hz )
+	{
+		fprintf(stderr, "Can't open %s\n", jarPath.toLocal8Bit().constData());
+		return false;
+	}
+
+	ZIPENTRYW ze;
+	ZRESULT zr = GetZipItem( hz, -1, &ze );
+	int numitems = (zr == ZR_OK) ? ze.index : 0;
+	for( int i = 0; i < numitems; i++ )
+	{
+		GetZipItem( hz, i, &ze );
+		QString fileName = QString::fromStdWString(ze.name);
+		if(!isClassEntry(fileName))
+			continue;
+
+		QString tempPath = tempBase + fileName.mid(fileName.lastIndexOf('.'));
+		zr = UnzipItem(hz, i, (void*)tempPath.toStdWString().c_str(), 0, ZIP_FILENAME);
+		if( zr != ZR_OK )
+		{
+			fprintf(stderr, "Can't unzip %s\n", fileName.toLocal8Bit().constData());
+			CloseZip(hz);
+			return false;
+		}
+		rows.append(tempFileRow(fileName, ze.unc_size, tempPath));
+		QFile::remove(tempPath);
+	}
+	CloseZip(hz);
+#else
+	JarReader reader;
+	if(!reader.open(jarPath))
+	{
+		fprintf(stderr, "%s\n", reader.errorString().toLocal8Bit().constData());
+		return false;
+	}
+
+	for(int i = 0; i < reader.count(); i++)
+	{
+		const JarEntry &entry = reader.entry(i);
+		if(!isClassEntry(entry.name))
+			continue;
+
+		QString tempPath = tempBase + entry.name.mid(entry.name.lastIndexOf('.'));
+		QFile output(tempPath);
+		if(!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+			return false;
+		output.write(reader.read(i));
+		output.close();
+		rows.append(tempFileRow(entry.name, (long)entry.uncompressedSize, tempPath));
+		QFile::remove(tempPath);
+	}
+#endif
+
+	QFile outputFile(outputPath);
+	if(!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+	{
+		fprintf(stderr, "Failed to create %s\n", outputPath.toLocal8Bit().constData());
+		return false;
+	}
+	QTextStream out(&outputFile);
+	out.setCodec("UTF-8");
+	out << rows.join("\n") << "\n";
+	return true;
+}
+
+// a class table of the given references, class i being symbol i
+static ClassTable makeClasses(int count, const int (*references)[2], int referenceCount)
+{
+	ClassTable classes;
+	for(int i = 0; i < count; i++)
+		classes.append(i, 0, i, 0, 100, false);
+	for(int i = 0; i < referenceCount; i++)
+	{
+		QVector<int> list = classes.referencedList(references[i][0]);
+		list.append(references[i][1]);
+		classes.setReferencedList(references[i][0], list);
+	}
+	return classes;
+}
+
+// R -> L <- D, L -> M : L and M only hang on the root R, the unreachable D doesn't cut their paths
+static void testDominatorsIgnoreUnreachableClasses()
+{
+	enum { R, L, D, M, COUNT };
+	const int references[][2] = { { R, L }, { D, L }, { L, M } };
+	ClassTable classes = makeClasses(COUNT, references, 3);
+	DependencyGraph graph;
+	graph.build(classes, COUNT);
+
+	QVector<int> idom = graph.dominators(QVector<int>(1, graph.node(R)));
+	CHECK(idom.at(graph.node(R)) == COUNT);
+	CHECK(idom.at(graph.node(L)) == graph.node(R));
+	CHECK(idom.at(graph.node(M)) == graph.node(L));
+	CHECK(idom.at(graph.node(D)) == COUNT);
+
+	// without roots R and D are both entries and L has two ways in
+	idom = graph.dominators(QVector<int>());
+	CHECK(idom.at(graph.node(R)) == COUNT);
+	CHECK(idom.at(graph.node(D)) == COUNT);
+	CHECK(idom.at(graph.node(L)) == COUNT);
+	CHECK(idom.at(graph.node(M)) == graph.node(L));
+}
+
+// R -> A -> B, R -> B, dead cycle C <-> E -> B : B is reached two ways from R, C and E are
+// unreachable and the entry of their cycle dominates the other
+static void testDominatorsOfUnreachableCycle()
+{
+	enum { R, A, B, C, E, COUNT };
+	const int references[][2] = { { R, A }, { A, B }, { R, B }, { C, E }, { E, C }, { E, B } };
+	ClassTable classes = makeClasses(COUNT, references, 6);
+	DependencyGraph graph;
+	graph.build(classes, COUNT);
+
+	QVector<int> idom = graph.dominators(QVector<int>(1, graph.node(R)));
+	CHECK(idom.at(graph.node(A)) == graph.node(R));
+	CHECK(idom.at(graph.node(B)) == graph.node(R));
+	int deadEntry = (idom.at(graph.node(C)) == COUNT) ? C : E;
+	int deadOther = (deadEntry == C) ? E : C;
+	CHECK(idom.at(graph.node(deadEntry)) == COUNT);
+	CHECK(idom.at(graph.node(deadOther)) == graph.node(deadEntry));
+}
+
+// JarLoader gives every .class and .java entry of loader.jar the row the temp file loader gave it
+static void testJarLoaderMatchesTempFileLoader(const QString &fixtures)
+{
+	QFile expectedFile(fixtures + "/loader.expected");
+	CHECK(expectedFile.open(QIODevice::ReadOnly | QIODevice::Text));
+	QStringList expected = QString::fromUtf8(expectedFile.readAll()).split("\n", QString::SkipEmptyParts);
+
+	JarReader reader;
+	CHECK(reader.open(fixtures + "/loader.jar"));
+	if(!reader.isOpen())
+		return;
+
+	SymbolTable symbols;
+	ClassTable classes;
+	JarLoader loader(reader, symbols);
+	loader.load(classes);
+
+	CHECK(classes.size() == expected.size());
+	for(int row = 0; row < classes.size() && row < expected.size(); row++)
+	{
+		QStringList referencedList;
+		const QVector<int> &ids = classes.referencedList(row);
+		for(int i = 0; i < ids.size(); i++)
+			referencedList.append(symbols.text(ids.at(i)));
+
+		CHECK(classes.parseError(row).isEmpty());
+		CHECK_EQUAL(classRow(symbols.text(classes.classId(row)), classes.fileSize(row), classes.methodCount(row), referencedList),
+			expected.at(row));
+	}
+}
+
+// A class written by mkfixtures.py as javac --release N lays it out, with the data of its parse.
+// The names are in internal form, sorted.
+struct ReleaseClass
+{
+	const char *path;
+	int methodCount;
+	const char *referencedClasses;
+};
+
+static const ReleaseClass releaseClasses[] =
+{
+	{ "release8/Lambdas.class", 4, "java/io/PrintStream java/lang/Object java/lang/String java/lang/System "
+		"java/lang/invoke/LambdaMetafactory java/lang/invoke/MethodHandles java/lang/invoke/MethodHandles$Lookup" },
+	{ "release11/Outer.class", 2, "Outer$Inner java/lang/Object java/lang/invoke/MethodHandles "
+		"java/lang/invoke/MethodHandles$Lookup java/lang/invoke/StringConcatFactory" },
+	{ "release11/Outer$Inner.class", 2, "Outer java/lang/Object" },
+	{ "release11/module-info.class", 0, "" },
+	{ "release17/Point.class", 6, "java/lang/Record java/lang/invoke/MethodHandles java/lang/invoke/MethodHandles$Lookup "
+		"java/lang/runtime/ObjectMethods" },
+	{ "release17/Shape.class", 1, "Circle Square java/lang/Object" },
+	{ "release21/Patterns.class", 3, "java/lang/Integer java/lang/Object java/lang/String java/lang/invoke/ConstantBootstraps "
+		"java/lang/invoke/MethodHandles java/lang/invoke/MethodHandles$Lookup java/lang/runtime/SwitchBootstraps java/util/Objects" }
+};
+
+// external form of a CONSTANT_Class name, as jclass_cp_get_class_name() gives it
+static QString cpClassName(const ConstantPool *constant_pool, uint16_t index)
+{
+	char *class_name = jclass_cp_get_class_name(constant_pool, index, 0);
+	QString name = QString::fromUtf8(class_name != NULL ? class_name : "");
+	free(class_name);
+	return name;
+}
+
+static QString cpUtf8(const ConstantPool *constant_pool, uint16_t index)
+{
+	const UTF8Entry *utf8 = constant_pool->entries[index].info.utf8;
+	return QString::fromUtf8((const char *)utf8->contents, utf8->length);
+}
+
+// class of the method a bootstrap method handle calls
+static QString bootstrapOwner(const ConstantPool *constant_pool, uint16_t methodHandle)
+{
+	if(constant_pool->entries[methodHandle].tag != CONSTANT_MethodHandle)
+		return QString();
+	uint16_t reference = constant_pool->entries[methodHandle].info.methodhandle.reference_index;
+	return cpClassName(constant_pool, constant_pool->entries[reference].info.ref.class_index);
+}
+
+static QString argumentTags(const ConstantPool *constant_pool, const BootstrapMethodInfo &method)
+{
+	QStringList tags;
+	for(int i = 0; i < method.no_arguments; i++)
+		tags.append(QString::number(constant_pool->entries[method.arguments[i]].tag));
+	return tags.join(" ");
+}
+
+static const AttributeContainer *findAttribute(const JavaClass *clazz, const char *name)
+{
+	for(int i = 0; i < clazz->attributes_count; i++)
+	{
+		if(jclass_attribute_container_has_attribute(&clazz->attributes[i], name, clazz->constant_pool))
+			return &clazz->attributes[i];
+	}
+	return NULL;
+}
+
+static QString classesOfAttribute(const JavaClass *clazz, const char *name)
+{
+	const AttributeContainer *container = findAttribute(clazz, name);
+	if(container == NULL)
+		return QString("no %1").arg(name);
+
+	NestMembersAttribute *attribute = jclass_nestmembers_attribute_new(container);
+	QStringList classes;
+	for(int i = 0; i < attribute->no_classes; i++)
+		classes.append(cpClassName(clazz->constant_pool, attribute->classes[i]));
+	jclass_nestmembers_attribute_free(attribute);
+	return classes.join(" ");
+}
+
+// "owner:argument tags" of every bootstrap method
+static QString bootstrapMethods(const JavaClass *clazz)
+{
+	const AttributeContainer *container = findAttribute(clazz, "BootstrapMethods");
+	if(container == NULL)
+		return QString("no BootstrapMethods");
+
+	BootstrapMethodsAttribute *attribute = jclass_bootstrapmethods_attribute_new(container);
+	QStringList methods;
+	for(int i = 0; i < attribute->no_bootstrap_methods; i++)
+	{
+		methods.append(bootstrapOwner(clazz->constant_pool, attribute->methods[i].method_ref) + ":" +
+			argumentTags(clazz->constant_pool, attribute->methods[i]));
+	}
+	jclass_bootstrapmethods_attribute_free(attribute);
+	return methods.join(" ");
+}
+
+// "name descriptor attribute names" of every record component
+static QString recordComponents(const JavaClass *clazz)
+{
+	const AttributeContainer *container = findAttribute(clazz, "Record");
+	if(container == NULL)
+		return QString("no Record");
+
+	RecordAttribute *attribute = jclass_record_attribute_new(container);
+	QStringList components;
+	for(int i = 0; i < attribute->no_components; i++)
+	{
+		const RecordComponentInfo &component = attribute->components[i];
+		QString text = cpUtf8(clazz->constant_pool, component.name_index) + " " + cpUtf8(clazz->constant_pool, component.descriptor_index);
+		for(int j = 0; j < component.attributes_count; j++)
+			text += " " + cpUtf8(clazz->constant_pool, component.attributes[j].name_index);
+		components.append(text);
+	}
+	jclass_record_attribute_free(attribute);
+	return components.join(", ");
+}
+
+static int countTag(const ConstantPool *constant_pool, int tag)
+{
+	int count = 0;
+	for(int i = 1; i < constant_pool->count; i++)
+	{
+		if(constant_pool->entries[i].tag == tag)
+			count++;
+	}
+	return count;
+}
+
+// method count and CONSTANT_Class names of a full parse, the class itself left out
+static void checkFullParse(const JavaClass *clazz, const ReleaseClass &expected, const char *file, int line)
+{
+	check(clazz != NULL, "parsed", file, line);
+	if(clazz == NULL)
+		return;
+
+	QString this_class = cpClassName(clazz->constant_pool, clazz->constant_pool->this_class);
+	QStringList referencedList;
+	for(int count = 1; count < clazz->constant_pool->count; count++)
+	{
+		if(clazz->constant_pool->entries[count].tag != CONSTANT_Class)
+			continue;
+		QString name = cpClassName(clazz->constant_pool, count);
+		if(name != this_class)
+			referencedList.append(name.replace(".", "/"));
+	}
+	checkEqual(classRow(expected.path, 0, clazz->methods_count, referencedList),
+		classRow(expected.path, 0, expected.methodCount, QString(expected.referencedClasses).split(" ", QString::SkipEmptyParts)), file, line);
+}
+
+// the attribute extractors on a full parse of each class that has the attribute
+static void checkAttributes(const JavaClass *clazz, const QString &path)
+{
+	if(path.endsWith("Lambdas.class"))
+	{
+		QString metafactory = "java.lang.invoke.LambdaMetafactory:16 15 16";
+		CHECK_EQUAL(bootstrapMethods(clazz), metafactory + " " + metafactory);
+		CHECK(countTag(clazz->constant_pool, CONSTANT_InvokeDynamic) == 2);
+	}
+	else if(path.endsWith("Outer.class"))
+	{
+		CHECK_EQUAL(classesOfAttribute(clazz, "NestMembers"), QString("Outer$Inner"));
+		CHECK_EQUAL(bootstrapMethods(clazz), QString("java.lang.invoke.StringConcatFactory:8"));
+	}
+	else if(path.endsWith("Outer$Inner.class"))
+	{
+		const AttributeContainer *container = findAttribute(clazz, "NestHost");
+		CHECK(container != NULL);
+		if(container == NULL)
+			return;
+		NestHostAttribute *attribute = jclass_nesthost_attribute_new(container);
+		CHECK_EQUAL(cpClassName(clazz->constant_pool, attribute->host_class_index), QString("Outer"));
+		jclass_nesthost_attribute_free(attribute);
+	}
+	else if(path.endsWith("module-info.class"))
+	{
+		CHECK(clazz->access_flags == 0x8000);
+		CHECK(countTag(clazz->constant_pool, CONSTANT_Module) == 3);
+		CHECK(countTag(clazz->constant_pool, CONSTANT_Package) == 2);
+	}
+	else if(path.endsWith("Point.class"))
+	{
+		CHECK_EQUAL(recordComponents(clazz), QString("x I, labels Ljava/util/List; Signature"));
+		CHECK_EQUAL(bootstrapMethods(clazz), QString("java.lang.runtime.ObjectMethods:7 8 15 15"));
+	}
+	else if(path.endsWith("Shape.class"))
+	{
+		CHECK_EQUAL(classesOfAttribute(clazz, "PermittedSubclasses"), QString("Circle Square"));
+	}
+	else if(path.endsWith("Patterns.class"))
+	{
+		CHECK_EQUAL(bootstrapMethods(clazz), QString("java.lang.runtime.SwitchBootstraps:7 7 java.lang.invoke.ConstantBootstraps:"));
+		CHECK(countTag(clazz->constant_pool, CONSTANT_Dynamic) == 1);
+	}
+}
+
+// The classes of each release parse the same with the view JarLoader uses, the buffer parser
+// and the file parser, and the extractors of their Java 7+ attributes read them back
+static void testReleaseClasses(const QString &fixtures)
+{
+	SymbolTable symbols;
+	ClassTable classes;
+	for(unsigned int i = 0; i < sizeof(releaseClasses) / sizeof(releaseClasses[0]); i++)
+	{
+		const ReleaseClass &expected = releaseClasses[i];
+		QString path = fixtures + "/" + expected.path;
+		QFile file(path);
+		CHECK(file.open(QIODevice::ReadOnly));
+		QByteArray bytes = file.readAll();
+		file.close();
+
+		int row = classes.append(symbols.intern(QByteArray(expected.path)), 0, i, 0, bytes.size(), false);
+		CHECK(JarLoader::collectJavaClassInfo(bytes, classes, row, symbols));
+		CHECK_EQUAL(classes.parseError(row), QString());
+		QStringList referencedList;
+		const QVector<int> &ids = classes.referencedList(row);
+		for(int j = 0; j < ids.size(); j++)
+			referencedList.append(QString::fromUtf8(symbols.bytes(ids.at(j))));
+		CHECK_EQUAL(classRow(expected.path, 0, classes.methodCount(row), referencedList),
+			classRow(expected.path, 0, expected.methodCount, QString(expected.referencedClasses).split(" ", QString::SkipEmptyParts)));
+
+		JavaClass *fromBuffer = jclass_class_new_from_buffer(bytes.constData());
+		checkFullParse(fromBuffer, expected, __FILE__, __LINE__);
+		JavaClass *fromFile = jclass_class_new(QFile::encodeName(path).constData(), NULL);
+		checkFullParse(fromFile, expected, __FILE__, __LINE__);
+
+		if(fromBuffer != NULL)
+		{
+			checkAttributes(fromBuffer, path);
+			jclass_class_free(fromBuffer);
+		}
+		if(fromFile != NULL)
+		{
+			checkAttributes(fromFile, path);
+			jclass_class_free(fromFile);
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	QStringList args = a.arguments();
+	if(args.size() == 4 && args.at(1) == "--write-loader-expected")
+		return writeLoaderExpected(args.at(2), args.at(3)) ? 0 : 2;
+	if(args.size() > 2 || (args.size() == 2 && args.at(1).startsWith("--")))
+	{
+		fprintf(stderr,
+			"Usage: ClassSpaceCheckerTest [fixtures directory]\n"
+			"       ClassSpaceCheckerTest --write-loader-expected <jar file> <output file>\n");
+		return 1;
+	}
+	QString fixtures = (args.size() == 2) ? args.at(1) : QString("ClassSpaceCheckerTest/fixtures");
+
+	testDominatorsIgnoreUnreachableClasses();
+	testDominatorsOfUnreachableCycle();
+	testJarLoaderMatchesTempFileLoader(fixtures);
+	testReleaseClasses(fixtures);
+
+	if(failureCount > 0)
+	{
+		fprintf(stderr, "%d checks failed\n", failureCount);
+		return 1;
+	}
+	printf("All tests passed\n");
+	return 0;
+}
@@ -0,0 +1,401 @@
+#!/usr/bin/env python3
+# Writes the fixtures of ClassSpaceCheckerTest, the same bytes on every run.
+#
+#   mkfixtures.py [fixtures_dir]
+#
+# loader.jar    a few classes and a source over STORED and DEFLATE entries, with inner and
+#               anonymous classes and array references. Its expected rows (loader.expected)
+#               come from ClassSpaceCheckerTest --write-loader-expected, see main.cpp.
+# releaseN/     classes laid out the way javac --release N compiles the sources quoted above
+#               each writer (class file version, constant pool entries in javac's order of
+#               first use, attributes), for the constant pool tags and attributes of Java 7+:
+#   release8/Lambdas.class                  lambda and method reference, BootstrapMethods
+#   release11/Outer.class, Outer$Inner      NestMembers and NestHost, indy string concat
+#   release11/module-info.class             Module and Package entries
+#   release17/Point.class                   Record, ObjectMethods bootstrap
+#   release17/Shape.class                   PermittedSubclasses
+#   release21/Patterns.class                typeSwitch bootstrap, a CONSTANT_Dynamic loaded by ldc
+
+import os
+import struct
+import sys
+import zipfile
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'ClassSpaceCheckerBench'))
+from mkjar import small_class
+
+# fixed entry times, so the jar bytes don't change from one run to the next
+DATE_TIME = (2013, 1, 1, 0, 0, 0)
+
+
+def add(jar, name, data, method):
+    info = zipfile.ZipInfo(name, DATE_TIME)
+    info.compress_type = method
+    jar.writestr(info, data)
+
+
+def u1(value):
+    return struct.pack('>B', value)
+
+
+def u2(value):
+    return struct.pack('>H', value)
+
+
+def u4(value):
+    return struct.pack('>I', value)
+
+
+class ConstantPool(object):
+    """Entries added on first use, the same constant only once, like javac"""
+
+    def __init__(self):
+        self.entries = []
+        self.indexes = {}
+
+    def add(self, key, data):
+        if key not in self.indexes:
+            self.entries.append(data)
+            self.indexes[key] = len(self.entries)
+        return self.indexes[key]
+
+    def utf8(self, text):
+        data = text.encode()
+        return self.add(('utf8', text), u1(1) + u2(len(data)) + data)
+
+    def class_(self, name):
+        return self.add(('class', name), u1(7) + u2(self.utf8(name)))
+
+    def string(self, text):
+        return self.add(('string', text), u1(8) + u2(self.utf8(text)))
+
+    def name_and_type(self, name, descriptor):
+        return self.add(('nat', name, descriptor), u1(12) + u2(self.utf8(name)) + u2(self.utf8(descriptor)))
+
+    def member(self, tag, owner, name, descriptor):
+        owner_index = self.class_(owner)
+        nat = self.name_and_type(name, descriptor)
+        return self.add((tag, owner, name, descriptor), u1(tag) + u2(owner_index) + u2(nat))
+
+    def fieldref(self, owner, name, descriptor):
+        return self.member(9, owner, name, descriptor)
+
+    def methodref(self, owner, name, descriptor):
+        return self.member(10, owner, name, descriptor)
+
+    def method_handle(self, kind, reference):
+        return self.add(('handle', kind, reference), u1(15) + u1(kind) + u2(reference))
+
+    def method_type(self, descriptor):
+        return self.add(('type', descriptor), u1(16) + u2(self.utf8(descriptor)))
+
+    def dynamic(self, bootstrap, name, descriptor):
+        nat = self.name_and_type(name, descriptor)
+        return self.add(('dynamic', bootstrap, nat), u1(17) + u2(bootstrap) + u2(nat))
+
+    def invoke_dynamic(self, bootstrap, name, descriptor):
+        nat = self.name_and_type(name, descriptor)
+        return self.add(('indy', bootstrap, nat), u1(18) + u2(bootstrap) + u2(nat))
+
+    def module(self, name):
+        return self.add(('module', name), u1(19) + u2(self.utf8(name)))
+
+    def package(self, name):
+        return self.add(('package', name), u1(20) + u2(self.utf8(name)))
+
+    def bytes(self):
+        return u2(len(self.entries) + 1) + b''.join(self.entries)
+
+
+REF_GET_FIELD = 1
+REF_INVOKE_VIRTUAL = 5
+REF_INVOKE_STATIC = 6
+
+ACC_PUBLIC = 0x0001
+ACC_PRIVATE = 0x0002
+ACC_STATIC = 0x0008
+ACC_FINAL = 0x0010
+ACC_SUPER = 0x0020
+ACC_INTERFACE = 0x0200
+ACC_ABSTRACT = 0x0400
+ACC_SYNTHETIC = 0x1000
+ACC_MODULE = 0x8000
+
+LOOKUP = 'java/lang/invoke/MethodHandles$Lookup'
+METAFACTORY_DESCRIPTOR = ('(Ljava/lang/invoke/MethodHandles$Lookup;Ljava/lang/String;Ljava/lang/invoke/MethodType;'
+    'Ljava/lang/invoke/MethodType;Ljava/lang/invoke/MethodHandle;Ljava/lang/invoke/MethodType;)Ljava/lang/invoke/CallSite;')
+
+
+class ClassWriter(object):
+    """One class file: the constant pool is filled while the members are added"""
+
+    def __init__(self, major, access, name, super_name, interfaces=()):
+        self.cp = ConstantPool()
+        self.major = major
+        self.access = access
+        self.this_index = self.cp.class_(name)
+        self.super_index = self.cp.class_(super_name) if super_name else 0
+        self.interfaces = [self.cp.class_(interface) for interface in interfaces]
+        self.fields = []
+        self.methods = []
+        self.attributes = []
+        self.bootstrap_methods = []
+
+    def attribute(self, name, data):
+        return u2(self.cp.utf8(name)) + u4(len(data)) + data
+
+    def member(self, access, name, descriptor, attributes):
+        return u2(access) + u2(self.cp.utf8(name)) + u2(self.cp.utf8(descriptor)) + u2(len(attributes)) + b''.join(attributes)
+
+    def field(self, access, name, descriptor, attributes=()):
+        self.fields.append(self.member(access, name, descriptor, list(attributes)))
+
+    def code(self, max_stack, max_locals, code):
+        return self.attribute('Code', u2(max_stack) + u2(max_locals) + u4(len(code)) + code + u2(0) + u2(0))
+
+    def method(self, access, name, descriptor, max_stack=0, max_locals=0, code=None, attributes=()):
+        attributes = list(attributes)
+        if code is not None:
+            attributes.insert(0, self.code(max_stack, max_locals, code))
+        self.methods.append(self.member(access, name, descriptor, attributes))
+
+    def bootstrap(self, kind, owner, name, descriptor, arguments):
+        handle = self.cp.method_handle(kind, self.cp.methodref(owner, name, descriptor))
+        self.bootstrap_methods.append(u2(handle) + u2(len(arguments)) + b''.join(u2(argument) for argument in arguments))
+        return len(self.bootstrap_methods) - 1
+
+    def inner_class(self, inner, outer, simple_name, access):
+        return (u2(self.cp.class_(inner)) + u2(self.cp.class_(outer) if outer else 0) +
+            u2(self.cp.utf8(simple_name) if simple_name else 0) + u2(access))
+
+    def lookup_inner_class(self):
+        return self.inner_class(LOOKUP, 'java/lang/invoke/MethodHandles', 'Lookup', ACC_PUBLIC | ACC_STATIC | ACC_FINAL)
+
+    def bytes(self):
+        attributes = list(self.attributes)
+        if self.bootstrap_methods:
+            attributes.append(self.attribute('BootstrapMethods',
+                u2(len(self.bootstrap_methods)) + b''.join(self.bootstrap_methods)))
+        out = u4(0xCAFEBABE) + u2(0) + u2(self.major) + self.cp.bytes()
+        out += u2(self.access) + u2(self.this_index) + u2(self.super_index)
+        out += u2(len(self.interfaces)) + b''.join(u2(index) for index in self.interfaces)
+        out += u2(len(self.fields)) + b''.join(self.fields)
+        out += u2(len(self.methods)) + b''.join(self.methods)
+        out += u2(len(attributes)) + b''.join(attributes)
+        return out
+
+
+def object_init(writer):
+    # aload_0, invokespecial Object.<init>, return
+    init = writer.cp.methodref('java/lang/Object', '<init>', '()V')
+    writer.method(ACC_PUBLIC, '<init>', '()V', 1, 1, b'\x2a\xb7' + u2(init) + b'\xb1')
+
+
+def invokedynamic(index):
+    return b'\xba' + u2(index) + b'\x00\x00'
+
+
+# public class Lambdas {
+#     public Runnable task() { return () -> System.out.println("run"); }
+#     public Function<String, Integer> length() { return String::length; }
+# }
+def lambdas_class():
+    writer = ClassWriter(52, ACC_PUBLIC | ACC_SUPER, 'Lambdas', 'java/lang/Object')
+    cp = writer.cp
+    object_init(writer)
+
+    metafactory = ('java/lang/invoke/LambdaMetafactory', 'metafactory', METAFACTORY_DESCRIPTOR)
+    run = cp.invoke_dynamic(0, 'run', '()Ljava/lang/Runnable;')
+    writer.method(ACC_PUBLIC, 'task', '()Ljava/lang/Runnable;', 1, 1, invokedynamic(run) + b'\xb0')
+    apply = cp.invoke_dynamic(1, 'apply', '()Ljava/util/function/Function;')
+    writer.method(ACC_PUBLIC, 'length', '()Ljava/util/function/Function;', 1, 1, invokedynamic(apply) + b'\xb0',
+        [writer.attribute('Signature', u2(cp.utf8('()Ljava/util/function/Function<Ljava/lang/String;Ljava/lang/Integer;>;')))])
+    out = cp.fieldref('java/lang/System', 'out', 'Ljava/io/PrintStream;')
+    println = cp.methodref('java/io/PrintStream', 'println', '(Ljava/lang/String;)V')
+    writer.method(ACC_PRIVATE | ACC_STATIC | ACC_SYNTHETIC, 'lambda$task$0', '()V', 2, 0,
+        b'\xb2' + u2(out) + b'\x12' + u1(cp.string('run')) + b'\xb6' + u2(println) + b'\xb1')
+
+    writer.bootstrap(REF_INVOKE_STATIC, *metafactory, arguments=[cp.method_type('()V'),
+        cp.method_handle(REF_INVOKE_STATIC, cp.methodref('Lambdas', 'lambda$task$0', '()V')), cp.method_type('()V')])
+    writer.bootstrap(REF_INVOKE_STATIC, *metafactory, arguments=[cp.method_type('(Ljava/lang/Object;)Ljava/lang/Object;'),
+        cp.method_handle(REF_INVOKE_VIRTUAL, cp.methodref('java/lang/String', 'length', '()I')),
+        cp.method_type('(Ljava/lang/String;)Ljava/lang/Integer;')])
+    writer.attributes.append(writer.attribute('SourceFile', u2(cp.utf8('Lambdas.java'))))
+    writer.attributes.append(writer.attribute('InnerClasses', u2(1) + writer.lookup_inner_class()))
+    return writer.bytes()
+
+
+# public class Outer {
+#     private int secret;
+#     public String describe() { return "secret " + secret; }
+#     class Inner { int peek() { return secret; } }
+# }
+def outer_classes():
+    writer = ClassWriter(55, ACC_PUBLIC | ACC_SUPER, 'Outer', 'java/lang/Object')
+    cp = writer.cp
+    writer.field(ACC_PRIVATE, 'secret', 'I')
+    object_init(writer)
+    secret = cp.fieldref('Outer', 'secret', 'I')
+    concat = cp.invoke_dynamic(0, 'makeConcatWithConstants', '(I)Ljava/lang/String;')
+    writer.method(ACC_PUBLIC, 'describe', '()Ljava/lang/String;', 1, 1,
+        b'\x2a\xb4' + u2(secret) + invokedynamic(concat) + b'\xb0')
+    writer.bootstrap(REF_INVOKE_STATIC, 'java/lang/invoke/StringConcatFactory', 'makeConcatWithConstants',
+        '(Ljava/lang/invoke/MethodHandles$Lookup;Ljava/lang/String;Ljava/lang/invoke/MethodType;'
+        'Ljava/lang/String;[Ljava/lang/Object;)Ljava/lang/invoke/CallSite;', [cp.string('secret \x01')])
+    writer.attributes.append(writer.attribute('SourceFile', u2(cp.utf8('Outer.java'))))
+    writer.attributes.append(writer.attribute('NestMembers', u2(1) + u2(cp.class_('Outer$Inner'))))
+    writer.attributes.append(writer.attribute('InnerClasses', u2(2) +
+        writer.inner_class('Outer$Inner', 'Outer', 'Inner', 0) + writer.lookup_inner_class()))
+    outer = writer.bytes()
+
+    writer = ClassWriter(55, ACC_SUPER, 'Outer$Inner', 'java/lang/Object')
+    cp = writer.cp
+    writer.field(ACC_FINAL | ACC_SYNTHETIC, 'this$0', 'LOuter;')
+    this0 = cp.fieldref('Outer$Inner', 'this$0', 'LOuter;')
+    init = cp.methodref('java/lang/Object', '<init>', '()V')
+    writer.method(0, '<init>', '(LOuter;)V', 2, 2, b'\x2a\x2b\xb5' + u2(this0) + b'\x2a\xb7' + u2(init) + b'\xb1')
+    secret = cp.fieldref('Outer', 'secret', 'I')
+    writer.method(0, 'peek', '()I', 1, 1, b'\x2a\xb4' + u2(this0) + b'\xb4' + u2(secret) + b'\xac')
+    writer.attributes.append(writer.attribute('SourceFile', u2(cp.utf8('Outer.java'))))
+    writer.attributes.append(writer.attribute('NestHost', u2(cp.class_('Outer'))))
+    writer.attributes.append(writer.attribute('InnerClasses', u2(1) + writer.inner_class('Outer$Inner', 'Outer', 'Inner', 0)))
+    return outer, writer.bytes()
+
+
+# module com.fx.app {
+#     requires java.logging;
+#     exports com.fx.app;
+# }
+def module_info_class():
+    writer = ClassWriter(55, ACC_MODULE, 'module-info', None)
+    cp = writer.cp
+    module = (u2(cp.module('com.fx.app')) + u2(0) + u2(0) +
+        u2(2) + u2(cp.module('java.base')) + u2(0x8000) + u2(cp.utf8('11')) +
+        u2(cp.module('java.logging')) + u2(0) + u2(cp.utf8('11')) +
+        u2(1) + u2(cp.package('com/fx/app')) + u2(0) + u2(0) +
+        u2(0) + u2(0) + u2(0))
+    writer.attributes.append(writer.attribute('SourceFile', u2(cp.utf8('module-info.java'))))
+    writer.attributes.append(writer.attribute('Module', module))
+    writer.attributes.append(writer.attribute('ModulePackages', u2(2) + u2(cp.package('com/fx/app')) + u2(cp.package('com/fx/util'))))
+    return writer.bytes()
+
+
+# public record Point(int x, List<String> labels) {}
+def point_class():
+    writer = ClassWriter(61, ACC_PUBLIC | ACC_FINAL | ACC_SUPER, 'Point', 'java/lang/Record')
+    cp = writer.cp
+    labels_signature = 'Ljava/util/List<Ljava/lang/String;>;'
+    signature = lambda text: writer.attribute('Signature', u2(cp.utf8(text)))
+    writer.field(ACC_PRIVATE | ACC_FINAL, 'x', 'I')
+    writer.field(ACC_PRIVATE | ACC_FINAL, 'labels', 'Ljava/util/List;', [signature(labels_signature)])
+
+    record_init = cp.methodref('java/lang/Record', '<init>', '()V')
+    x = cp.fieldref('Point', 'x', 'I')
+    labels = cp.fieldref('Point', 'labels', 'Ljava/util/List;')
+    writer.method(ACC_PUBLIC, '<init>', '(ILjava/util/List;)V', 2, 3,
+        b'\x2a\xb7' + u2(record_init) + b'\x2a\x1b\xb5' + u2(x) + b'\x2a\x2c\xb5' + u2(labels) + b'\xb1',
+        [signature('(ILjava/util/List<Ljava/lang/String;>;)V')])
+    to_string = cp.invoke_dynamic(0, 'toString', '(LPoint;)Ljava/lang/String;')
+    writer.method(ACC_PUBLIC | ACC_FINAL, 'toString', '()Ljava/lang/String;', 1, 1, b'\x2a' + invokedynamic(to_string) + b'\xb0')
+    hash_code = cp.invoke_dynamic(0, 'hashCode', '(LPoint;)I')
+    writer.method(ACC_PUBLIC | ACC_FINAL, 'hashCode', '()I', 1, 1, b'\x2a' + invokedynamic(hash_code) + b'\xac')
+    equals = cp.invoke_dynamic(0, 'equals', '(LPoint;Ljava/lang/Object;)Z')
+    writer.method(ACC_PUBLIC | ACC_FINAL, 'equals', '(Ljava/lang/Object;)Z', 2, 2, b'\x2a\x2b' + invokedynamic(equals) + b'\xac')
+    writer.method(ACC_PUBLIC, 'x', '()I', 1, 1, b'\x2a\xb4' + u2(x) + b'\xac')
+    writer.method(ACC_PUBLIC, 'labels', '()Ljava/util/List;', 1, 1, b'\x2a\xb4' + u2(labels) + b'\xb0',
+        [signature('()Ljava/util/List<Ljava/lang/String;>;')])
+
+    writer.bootstrap(REF_INVOKE_STATIC, 'java/lang/runtime/ObjectMethods', 'bootstrap',
+        '(Ljava/lang/invoke/MethodHandles$Lookup;Ljava/lang/String;Ljava/lang/invoke/TypeDescriptor;'
+        'Ljava/lang/Class;Ljava/lang/String;[Ljava/lang/invoke/MethodHandle;)Ljava/lang/Object;',
+        [cp.class_('Point'), cp.string('x;labels'), cp.method_handle(REF_GET_FIELD, x), cp.method_handle(REF_GET_FIELD, labels)])
+    writer.attributes.append(writer.attribute('SourceFile', u2(cp.utf8('Point.java'))))
+    writer.attributes.append(writer.attribute('Record', u2(2) +
+        u2(cp.utf8('x')) + u2(cp.utf8('I')) + u2(0) +
+        u2(cp.utf8('labels')) + u2(cp.utf8('Ljava/util/List;')) + u2(1) + signature(labels_signature)))
+    writer.attributes.append(writer.attribute('InnerClasses', u2(1) + writer.lookup_inner_class()))
+    return writer.bytes()
+
+
+# public sealed interface Shape permits Circle, Square { double area(); }
+def shape_class():
+    writer = ClassWriter(61, ACC_PUBLIC | ACC_INTERFACE | ACC_ABSTRACT, 'Shape', 'java/lang/Object')
+    cp = writer.cp
+    writer.method(ACC_PUBLIC | ACC_ABSTRACT, 'area', '()D')
+    writer.attributes.append(writer.attribute('SourceFile', u2(cp.utf8('Shape.java'))))
+    writer.attributes.append(writer.attribute('PermittedSubclasses', u2(2) + u2(cp.class_('Circle')) + u2(cp.class_('Square'))))
+    return writer.bytes()
+
+
+# public class Patterns {
+#     static int kind(Object o) {
+#         return switch (o) { case String s -> 1; case Integer i -> 2; default -> 0; };
+#     }
+#     static Object none() { return <ldc of a dynamic constant from ConstantBootstraps.nullConstant>; }
+# }
+# javac emits no CONSTANT_Dynamic from Java source, none() has the ldc other compilers emit.
+def patterns_class():
+    writer = ClassWriter(65, ACC_PUBLIC | ACC_SUPER, 'Patterns', 'java/lang/Object')
+    cp = writer.cp
+    object_init(writer)
+    requires_non_null = cp.methodref('java/util/Objects', 'requireNonNull', '(Ljava/lang/Object;)Ljava/lang/Object;')
+    type_switch = cp.invoke_dynamic(0, 'typeSwitch', '(Ljava/lang/Object;I)I')
+    code = (b'\x2a\x59\xb8' + u2(requires_non_null) + b'\x57\x4c\x03\x3d\x2b\x1c' + invokedynamic(type_switch) +
+        # tableswitch at 16, padded to 20 : default, low 0, high 1, then the returns at 40
+        b'\xaa\x00\x00\x00' + u4(28) + u4(0) + u4(1) + u4(24) + u4(26) + b'\x04\xac\x05\xac\x03\xac')
+    writer.method(ACC_STATIC, 'kind', '(Ljava/lang/Object;)I', 2, 4, code)
+    writer.bootstrap(REF_INVOKE_STATIC, 'java/lang/runtime/SwitchBootstraps', 'typeSwitch',
+        '(Ljava/lang/invoke/MethodHandles$Lookup;Ljava/lang/String;Ljava/lang/invoke/MethodType;'
+        '[Ljava/lang/Object;)Ljava/lang/invoke/CallSite;', [cp.class_('java/lang/String'), cp.class_('java/lang/Integer')])
+    none = cp.dynamic(1, '_', 'Ljava/lang/Object;')
+    writer.method(ACC_STATIC, 'none', '()Ljava/lang/Object;', 1, 0, b'\x13' + u2(none) + b'\xb0')
+    writer.bootstrap(REF_INVOKE_STATIC, 'java/lang/invoke/ConstantBootstraps', 'nullConstant',
+        '(Ljava/lang/invoke/MethodHandles$Lookup;Ljava/lang/String;Ljava/lang/Class;)Ljava/lang/Object;', [])
+    writer.attributes.append(writer.attribute('SourceFile', u2(cp.utf8('Patterns.java'))))
+    writer.attributes.append(writer.attribute('InnerClasses', u2(1) + writer.lookup_inner_class()))
+    return writer.bytes()
+
+
+def write_class(directory, release, name, data):
+    path = os.path.join(directory, release)
+    if not os.path.isdir(path):
+        os.makedirs(path)
+    with open(os.path.join(path, name + '.class'), 'wb') as output:
+        output.write(data)
+
+
+def write_release_classes(directory):
+    write_class(directory, 'release8', 'Lambdas', lambdas_class())
+    outer, inner = outer_classes()
+    write_class(directory, 'release11', 'Outer', outer)
+    write_class(directory, 'release11', 'Outer$Inner', inner)
+    write_class(directory, 'release11', 'module-info', module_info_class())
+    write_class(directory, 'release17', 'Point', point_class())
+    write_class(directory, 'release17', 'Shape', shape_class())
+    write_class(directory, 'release21', 'Patterns', patterns_class())
+
+
+def write_loader_jar(path):
+    stored = zipfile.ZIP_STORED
+    deflated = zipfile.ZIP_DEFLATED
+    with zipfile.ZipFile(path, 'w') as jar:
+        add(jar, 'META-INF/MANIFEST.MF', 'Manifest-Version: 1.0\nMain-Class: com.fx.app.Main\n', deflated)
+        add(jar, 'com/fx/app/Main.class', small_class('com/fx/app/Main',
+            ['com/fx/app/Main$1', 'com/fx/util/Strings', '[Lcom/fx/util/Strings;', '[I', 'com/fx/app/Main'], 3), deflated)
+        add(jar, 'com/fx/app/Main$1.class', small_class('com/fx/app/Main$1', ['com/fx/app/Main', 'java/lang/Runnable'], 1), stored)
+        add(jar, 'com/fx/app/Main$Inner.class', small_class('com/fx/app/Main$Inner', ['com/fx/app/Main', '[[J'], 2), deflated)
+        add(jar, 'com/fx/util/Strings.class', small_class('com/fx/util/Strings',
+            ['java/lang/String', 'java/lang/StringBuilder', '[[Ljava/lang/String;'], 0), stored)
+        add(jar, 'com/fx/util/Strings.java', 'package com.fx.util;\n\nclass Strings {}\n', deflated)
+        add(jar, 'com/fx/Readme.txt', 'not a class\n', stored)
+        add(jar, 'Top.class', small_class('Top', ['com/fx/app/Main'], 4), deflated)
+
+
+if __name__ == '__main__':
+    if len(sys.argv) > 2:
+        sys.exit('usage: mkfixtures.py [fixtures_dir]')
+    directory = sys.argv[1] if len(sys.argv) == 2 else os.path.join(os.path.dirname(os.path.abspath(__file__)), 'fixtures')
+    if not os.path.isdir(directory):
+        os.makedirs(directory)
+    write_loader_jar(os.path.join(directory, 'loader.jar'))
+    write_release_classes(directory)
@@ -0,0 +1,148 @@
+// Fuzz target of jclass_class_view_from_buffer(), the parser the jar loader runs on every
+// .class entry of an analyzed jar, followed by the constant pool lookups the loader does.
+//
+// libFuzzer build, from the repository root (clang 6 or later) :
+//   clang -g -O1 -fsanitize=fuzzer,address,undefined -DHAVE_UNISTD_H -IClassSpaceChecker fuzz/fuzz_class_view.c ClassSpaceChecker/jclass/*.c -lm -o fuzz_class_view
+//   mkdir corpus && unzip -j -o app.jar '*.class' -d corpus
+//   ./fuzz_class_view corpus
+//
+// Without libFuzzer (gcc, Visual C++), FUZZ_STANDALONE builds a driver running the target on
+// each file given, on every truncation of it and on FUZZ_MUTATIONS copies with a few bytes
+// changed (fixed seed, so a finding can be replayed) :
+//   gcc -g -fsanitize=address,undefined -DFUZZ_STANDALONE -DHAVE_UNISTD_H -IClassSpaceChecker fuzz/fuzz_class_view.c ClassSpaceChecker/jclass/*.c -lm -o fuzz_class_view
+//   ./fuzz_class_view corpus/*.class
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <jclass/jclass.h>
+#include <jclass/arena.h>
+
+#define FUZZ_MUTATIONS 256
+
+static volatile unsigned int sink;
+
+/* Reads every name the view hands out, so a pointer past the class is caught by ASan */
+static void walk_view(const JavaClassView *view)
+{
+	const ConstantPoolView *cpool = &view->constant_pool;
+	const char *name;
+	unsigned int sum = 0;
+	uint16_t length;
+	uint16_t i;
+	int index;
+
+	for(index = 1; index < cpool->count; index++)
+	{
+		name = jclass_cpview_get_utf8(cpool, (uint16_t) index, &length);
+		if(name == NULL)
+			name = jclass_cpview_get_class_name(cpool, (uint16_t) index, &length);
+		if(name == NULL)
+			continue;
+
+		for(i = 0; i < length; i++)
+			sum += (unsigned char) name[i];
+	}
+
+	name = jclass_cpview_get_class_name(cpool, cpool->this_class, &length);
+	if(name != NULL && length > 0)
+		sum += (unsigned char) name[length - 1];
+	name = jclass_cpview_get_class_name(cpool, cpool->super_class, &length);
+	if(name != NULL && length > 0)
+		sum += (unsigned char) name[length - 1];
+
+	sink += sum + view->methods_count + view->offset;
+}
+
+#ifdef __cplusplus
+extern "C"
+#endif
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	static JClassArena *arena = NULL;
+	JavaClassView view;
+
+	/* malloc'ed index arrays, released by jclass_class_view_free() */
+	if(jclass_class_view_from_buffer((const char *) data, size, &view, NULL) == JCLASS_OK)
+	{
+		walk_view(&view);
+		jclass_class_view_free(&view);
+	}
+
+	/* the same parse from an arena, as the loader workers do */
+	if(arena == NULL)
+		arena = jclass_arena_new(64 * 1024);
+	if(arena == NULL)
+		return 0;
+	if(jclass_class_view_from_buffer((const char *) data, size, &view, arena) == JCLASS_OK)
+		walk_view(&view);
+	jclass_arena_reset(arena);
+
+	return 0;
+}
+
+#ifdef FUZZ_STANDALONE
+
+/* Runs the target on a copy of exactly size bytes, so the end of the input is the end of the block */
+static void run_copy(const uint8_t *data, size_t size)
+{
+	uint8_t *copy = (uint8_t *) malloc(size > 0 ? size : 1);
+	memcpy(copy, data, size);
+	LLVMFuzzerTestOneInput(copy, size);
+	free(copy);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long seed = 1;
+	int run_count = 0;
+	int arg;
+
+	for(arg = 1; arg < argc; arg++)
+	{
+		FILE *file = fopen(argv[arg], "rb");
+		uint8_t *data;
+		uint8_t *mutated;
+		long size;
+		long length;
+		int mutation;
+		int k;
+
+		if(file == NULL)
+		{
+			fprintf(stderr, "Can't open %s\n", argv[arg]);
+			return 1;
+		}
+		fseek(file, 0, SEEK_END);
+		size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+		data = (uint8_t *) malloc(size > 0 ? size : 1);
+		if(fread(data, 1, size, file) != (size_t) size)
+			size = 0;
+		fclose(file);
+
+		for(length = 0; length <= size; length++, run_count++)
+			run_copy(data, length);
+
+		mutated = (uint8_t *) malloc(size > 0 ? size : 1);
+		for(mutation = 0; size > 0 && mutation < FUZZ_MUTATIONS; mutation++, run_count++)
+		{
+			memcpy(mutated, data, size);
+			for(k = 0; k < 1 + mutation % 4; k++)
+			{
+				seed = seed * 1103515245 + 12345;
+				mutated[(seed >> 8) % size] = (uint8_t) (seed >> 20);
+			}
+			run_copy(mutated, size);
+		}
+
+		free(mutated);
+		free(data);
+	}
+
+	printf("%d runs\n", run_count);
+	return 0;
+}
+
+#endif